@@ -0,0 +1,139 @@
+#include <koinos/chain/block_index.hpp>
+
+#include <koinos/chain/exceptions.hpp>
+
+#include <algorithm>
+#include <mutex>
+
+namespace koinos::chain {
+
+void block_index::reset( const indexed_block& root )
+{
+   std::unique_lock< std::shared_mutex > lock( _mutex );
+
+   _blocks.clear();
+   _heads.clear();
+
+   _root = root.id;
+   _blocks.emplace( root.id, entry { .block = root } );
+   _heads.insert( root.id );
+}
+
+void block_index::add( const indexed_block& block )
+{
+   std::unique_lock< std::shared_mutex > lock( _mutex );
+
+   if ( _blocks.count( block.id ) )
+      return;
+
+   // Blocks whose parent is not indexed are not reachable from the root
+   auto parent = _blocks.find( block.previous );
+   if ( parent == _blocks.end() )
+      return;
+
+   parent->second.children++;
+   _heads.erase( block.previous );
+
+   _blocks.emplace( block.id, entry { .block = block } );
+   _heads.insert( block.id );
+}
+
+void block_index::set_root( const std::string& id )
+{
+   std::unique_lock< std::shared_mutex > lock( _mutex );
+
+   auto root = _blocks.find( id );
+   KOINOS_ASSERT( root != _blocks.end(), internal_error_exception, "block index is missing the new root" );
+
+   if ( id == _root )
+      return;
+
+   std::vector< entry* > by_height;
+   by_height.reserve( _blocks.size() );
+
+   for ( auto& [ block_id, e ] : _blocks )
+   {
+      if ( e.block.height > root->second.block.height )
+         by_height.push_back( &e );
+   }
+
+   std::sort( by_height.begin(), by_height.end(), []( const entry* a, const entry* b ) { return a->block.height < b->block.height; } );
+
+   // Parents are visited before their children, so a block is kept when its parent was
+   std::unordered_map< std::string, entry > kept;
+   kept.emplace( id, entry { .block = root->second.block } );
+
+   for ( const auto* e : by_height )
+   {
+      auto parent = kept.find( e->block.previous );
+      if ( parent == kept.end() )
+         continue;
+
+      parent->second.children++;
+      kept.emplace( e->block.id, entry { .block = e->block } );
+   }
+
+   _blocks = std::move( kept );
+   _root = id;
+
+   _heads.clear();
+   for ( const auto& [ block_id, e ] : _blocks )
+   {
+      if ( !e.children )
+         _heads.insert( block_id );
+   }
+}
+
+std::optional< indexed_block > block_index::get( const std::string& id ) const
+{
+   std::shared_lock< std::shared_mutex > lock( _mutex );
+
+   if ( auto itr = _blocks.find( id ); itr != _blocks.end() )
+      return itr->second.block;
+
+   return {};
+}
+
+indexed_block block_index::root() const
+{
+   std::shared_lock< std::shared_mutex > lock( _mutex );
+
+   auto itr = _blocks.find( _root );
+   KOINOS_ASSERT( itr != _blocks.end(), internal_error_exception, "block index has not been initialized" );
+
+   return itr->second.block;
+}
+
+std::vector< indexed_block > block_index::fork_heads( const std::string& head_id ) const
+{
+   std::vector< indexed_block > heads;
+
+   {
+      std::shared_lock< std::shared_mutex > lock( _mutex );
+      heads.reserve( _heads.size() );
+
+      for ( const auto& id : _heads )
+         heads.push_back( _blocks.at( id ).block );
+   }
+
+   std::sort( heads.begin(), heads.end(), [&]( const indexed_block& a, const indexed_block& b )
+   {
+      if ( a.height != b.height )
+         return a.height > b.height;
+
+      if ( ( a.id == head_id ) != ( b.id == head_id ) )
+         return a.id == head_id;
+
+      return a.id < b.id;
+   } );
+
+   return heads;
+}
+
+std::size_t block_index::size() const
+{
+   std::shared_lock< std::shared_mutex > lock( _mutex );
+   return _blocks.size();
+}
+
+} // koinos::chain
@@ -0,0 +1,211 @@
+#include <koinos/chain/block_store_writer.hpp>
+
+#include <koinos/chain/exceptions.hpp>
+#include <koinos/exception.hpp>
+#include <koinos/log.hpp>
+
+#include <koinos/rpc/block_store/block_store_rpc.pb.h>
+
+#include <koinos/util/conversion.hpp>
+#include <koinos/util/hex.hpp>
+#include <koinos/util/services.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+namespace koinos::chain {
+
+using namespace std::chrono_literals;
+
+block_store_writer::block_store_writer( std::shared_ptr< mq::client > client, std::size_t max_backlog ) :
+   block_store_writer(
+      [client = std::move( client )]( const std::string& request )
+      {
+         return client->rpc( util::service::block_store, request, 1500ms, mq::retry_policy::none ).get();
+      },
+      max_backlog
+   )
+{}
+
+block_store_writer::block_store_writer( send_function send, std::size_t max_backlog ) :
+   _send( std::move( send ) ),
+   _max_backlog( std::max( max_backlog, std::size_t( 1 ) ) ),
+   _thread( [this]() { run(); } )
+{}
+
+block_store_writer::~block_store_writer()
+{
+   stop();
+}
+
+bool block_store_writer::add_block( const protocol::block& block, const protocol::block_receipt& receipt, std::chrono::milliseconds timeout )
+{
+   rpc::block_store::block_store_request req;
+   req.mutable_add_block()->mutable_block_to_add()->CopyFrom( block );
+   req.mutable_add_block()->mutable_receipt_to_add()->CopyFrom( receipt );
+
+   pending_block pending {
+      .id      = block.id(),
+      .height  = block.header().height(),
+      .request = util::converter::as< std::string >( req )
+   };
+
+   std::unique_lock< std::mutex > lock( _mutex );
+
+   auto ready = _acknowledged.wait_for( lock, timeout, [&]() { return _stopping || _error || _unacknowledged.size() < _max_backlog; } );
+
+   KOINOS_ASSERT( !_error, rpc_failure_exception, "block store rejected a block, no further blocks can be added: ${e}", ("e", *_error) );
+
+   if ( !ready || _stopping )
+      return false;
+
+   _unacknowledged.insert( pending.id );
+   _queue.emplace_back( std::move( pending ) );
+   _queued.notify_one();
+
+   return true;
+}
+
+bool block_store_writer::acknowledged( const std::string& block_id ) const
+{
+   std::lock_guard< std::mutex > lock( _mutex );
+   return !_unacknowledged.count( block_id );
+}
+
+bool block_store_writer::flush( std::chrono::milliseconds timeout )
+{
+   std::unique_lock< std::mutex > lock( _mutex );
+   return _acknowledged.wait_for( lock, timeout, [&]() { return _error || _unacknowledged.empty(); } ) && !_error;
+}
+
+std::optional< std::string > block_store_writer::error() const
+{
+   std::lock_guard< std::mutex > lock( _mutex );
+   return _error;
+}
+
+void block_store_writer::stop()
+{
+   {
+      std::lock_guard< std::mutex > lock( _mutex );
+
+      if ( _stopping )
+         return;
+
+      _stopping = true;
+
+      if ( _unacknowledged.size() )
+         LOG(warning) << "Stopping block store writer with " << _unacknowledged.size() << " unacknowledged blocks";
+   }
+
+   _queued.notify_all();
+   _acknowledged.notify_all();
+
+   if ( _thread.joinable() )
+      _thread.join();
+}
+
+void block_store_writer::run()
+{
+   for ( ;; )
+   {
+      std::vector< pending_block > batch;
+
+      {
+         std::unique_lock< std::mutex > lock( _mutex );
+         _queued.wait( lock, [&]() { return _stopping || _queue.size(); } );
+
+         if ( _stopping )
+            return;
+
+         // Everything queued so far is written before the queue is checked again
+         batch.reserve( _queue.size() );
+         std::move( _queue.begin(), _queue.end(), std::back_inserter( batch ) );
+         _queue.clear();
+      }
+
+      for ( const auto& block : batch )
+      {
+         auto backoff = 100ms;
+         std::string error;
+         write_result result;
+
+         while ( ( result = write( block, error ) ) == write_result::retry )
+         {
+            std::unique_lock< std::mutex > lock( _mutex );
+
+            if ( _queued.wait_for( lock, backoff, [&]() { return _stopping; } ) )
+               return;
+
+            backoff = std::min( backoff * 2, std::chrono::milliseconds( 5s ) );
+         }
+
+         // Later blocks depend on this one, so none of them can be written either
+         if ( result == write_result::rejected )
+         {
+            LOG(error) << "Block store rejected block - Height: " << block.height << ", ID: " << util::to_hex( block.id ) << ", no further blocks will be added: " << error;
+
+            {
+               std::lock_guard< std::mutex > lock( _mutex );
+               _error = error;
+               _queue.clear();
+            }
+
+            _acknowledged.notify_all();
+            return;
+         }
+
+         {
+            std::lock_guard< std::mutex > lock( _mutex );
+            _unacknowledged.erase( block.id );
+         }
+
+         _acknowledged.notify_all();
+      }
+   }
+}
+
+block_store_writer::write_result block_store_writer::write( const pending_block& block, std::string& error )
+{
+   std::string response;
+
+   try
+   {
+      response = _send( block.request );
+   }
+   catch ( const std::exception& e )
+   {
+      LOG(warning) << "Failed to add block to block store - Height: " << block.height << ", ID: " << util::to_hex( block.id ) << ", with reason: " << e.what();
+      return write_result::retry;
+   }
+   catch ( const boost::exception& e )
+   {
+      LOG(warning) << "Failed to add block to block store - Height: " << block.height << ", ID: " << util::to_hex( block.id ) << ", with reason: " << boost::diagnostic_information( e );
+      return write_result::retry;
+   }
+
+   rpc::block_store::block_store_response resp;
+
+   if ( !resp.ParseFromString( response ) )
+   {
+      error = "could not parse block store response";
+      return write_result::rejected;
+   }
+
+   if ( resp.has_error() )
+   {
+      error = resp.error().message();
+      return write_result::rejected;
+   }
+
+   if ( !resp.has_add_block() )
+   {
+      error = "unexpected block store response";
+      return write_result::rejected;
+   }
+
+   return write_result::written;
+}
+
+} // koinos::chain
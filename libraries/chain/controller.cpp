@@ -1,11 +1,16 @@
 #include <koinos/block_store/block_store.pb.h>
 #include <koinos/broadcast/broadcast.pb.h>
 
+#include <koinos/chain/block_index.hpp>
+#include <koinos/chain/block_store_writer.hpp>
 #include <koinos/chain/execution_context.hpp>
 #include <koinos/chain/constants.hpp>
 #include <koinos/chain/controller.hpp>
 #include <koinos/chain/exceptions.hpp>
 #include <koinos/chain/host_api.hpp>
+#include <koinos/chain/parallel_executor.hpp>
+#include <koinos/chain/read_contract_cache.hpp>
+#include <koinos/chain/signature_cache.hpp>
 #include <koinos/chain/state.hpp>
 #include <koinos/chain/system_calls.hpp>
 
@@ -27,14 +32,20 @@
 #include <koinos/vm_manager/vm_backend.hpp>
 
 #include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <cmath>
+#include <condition_variable>
+#include <future>
 #include <list>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
-#include <shared_mutex>
 #include <thread>
 
+#include <boost/asio/post.hpp>
+#include <boost/asio/thread_pool.hpp>
 #include <boost/interprocess/streams/vectorstream.hpp>
 
 namespace koinos::chain {
@@ -44,6 +55,9 @@ using namespace std::chrono_literals;
 
 using fork_data = std::pair< std::vector< block_topology >, block_topology >;
 
+// The number of blocks LIB may be held back by pinned reads before new reads wait for the commit
+constexpr uint64_t max_deferred_commits = 20;
+
 namespace detail {
 
 std::string format_time( int64_t time )
@@ -80,18 +94,30 @@ std::string format_time( int64_t time )
 class controller_impl final
 {
    public:
-      controller_impl( uint64_t read_compute_bandwith_limit, uint32_t syscall_bufsize );
+      controller_impl( uint64_t read_compute_bandwith_limit, uint32_t syscall_bufsize, const std::string& vm_backend_name, std::size_t module_cache_size );
       ~controller_impl();
 
       void open( const std::filesystem::path& p, const genesis_data& data, fork_resolution_algorithm algo, bool reset );
       void close();
       void set_client( std::shared_ptr< mq::client > c );
+      void set_block_store_writer( std::unique_ptr< block_store_writer > writer );
+      void set_module_directory( const std::filesystem::path& p );
+      void set_parallel_transactions( bool enabled );
+      void set_read_contract_cache_size( std::size_t entries );
+      void set_max_batch_size( std::size_t requests );
+      void set_batch_threads( std::size_t threads );
 
       rpc::chain::submit_block_response submit_block(
          const rpc::chain::submit_block_request&,
          uint64_t index_to,
          std::chrono::system_clock::time_point now
       );
+      rpc::chain::submit_block_response submit_block(
+         const prepared_block&,
+         uint64_t index_to,
+         std::chrono::system_clock::time_point now
+      );
+      std::shared_ptr< const prepared_block > prepare_block( protocol::block&& block );
 
       rpc::chain::submit_transaction_response submit_transaction( const rpc::chain::submit_transaction_request& );
       rpc::chain::get_head_info_response get_head_info( const rpc::chain::get_head_info_request& );
@@ -102,31 +128,107 @@ class controller_impl final
       rpc::chain::get_account_rc_response get_account_rc( const rpc::chain::get_account_rc_request& );
       rpc::chain::get_resource_limits_response get_resource_limits( const rpc::chain::get_resource_limits_request& );
       rpc::chain::invoke_system_call_response invoke_system_call( const rpc::chain::invoke_system_call_request& );
-
+      std::vector< rpc::chain::chain_response > batch( const std::vector< rpc::chain::chain_request >& requests, bool parallel );
 
    private:
       state_db::database                        _db;
       std::shared_ptr< vm_manager::vm_backend > _vm_backend;
       std::shared_ptr< mq::client >             _client;
+      std::unique_ptr< block_store_writer >     _block_store_writer;
       uint64_t                                  _read_compute_bandwidth_limit;
       uint32_t                                  _syscall_bufsize;
-      std::shared_mutex                         _cached_head_block_mutex;
-      std::shared_ptr< const protocol::block >  _cached_head_block;
+
+      struct head_snapshot
+      {
+         state_db::state_node_ptr                   node;
+         std::shared_ptr< const protocol::block >   block;
+         std::shared_ptr< execution_context_cache > cache;
+
+         // Computed once when the snapshot is published, so polling them never reads state
+         rpc::chain::get_head_info_response         head_info;
+         std::string                                chain_id;
+      };
+
+      // Replaced whenever the head changes and only ever accessed through std::atomic_load/store
+      std::shared_ptr< const head_snapshot >    _head_snapshot;
+
+      // Reads pin a snapshot instead of taking the database lock. Finalized nodes never change until a commit
+      // squashes them into the root, so commits wait until no snapshot is pinned. A commit is deferred while
+      // snapshots are pinned, and once max_deferred_commits have been deferred new pins wait for the commit.
+      struct pinned_head
+      {
+         std::shared_ptr< void >                  pin;
+         std::shared_ptr< const head_snapshot >   head;
+      };
+
+      std::mutex                                _commit_mutex;
+      std::mutex                                _pin_mutex;
+      std::condition_variable                   _pin_cv;
+      std::size_t                               _pins = 0;
+      bool                                      _committing = false;
+      uint64_t                                  _deferred_commits = 0;
+
+      // Execution context caches of finalized nodes, keyed by node id. Each entry pairs the cache with the node revision.
+      std::mutex                                _execution_caches_mutex;
+      std::map< std::string, std::pair< uint64_t, std::shared_ptr< execution_context_cache > > > _execution_caches;
+      block_index                               _block_index;
+      const std::size_t                         _worker_threads;
+      boost::asio::thread_pool                  _worker_pool;
+      verified_signature_cache                  _verified_signatures;
+      std::shared_ptr< parallel_executor >      _parallel_executor;
+      std::unique_ptr< read_contract_cache >    _read_contract_cache;
+      std::size_t                               _max_batch_size = default_max_batch_size;
+
+      // Batched reads run on their own pool, so they never wait behind block signature recovery or parallel transactions
+      std::unique_ptr< boost::asio::thread_pool > _batch_pool;
+
+      // Reads against a pinned head. The public overloads pin the current head.
+      rpc::chain::read_contract_response read_contract( const head_snapshot& head, const rpc::chain::read_contract_request& );
+      rpc::chain::get_account_nonce_response get_account_nonce( const head_snapshot& head, const rpc::chain::get_account_nonce_request& );
+      rpc::chain::get_account_rc_response get_account_rc( const head_snapshot& head, const rpc::chain::get_account_rc_request& );
+      rpc::chain::get_resource_limits_response get_resource_limits( const head_snapshot& head, const rpc::chain::get_resource_limits_request& );
+      rpc::chain::invoke_system_call_response invoke_system_call( const head_snapshot& head, const rpc::chain::invoke_system_call_request& );
+      void execute_batch_request( const head_snapshot& head, const rpc::chain::chain_request& request, rpc::chain::chain_response& response ) noexcept;
+
+      rpc::chain::read_contract_response execute_read_contract( const head_snapshot& head, const rpc::chain::read_contract_request& request );
 
       void validate_block( const protocol::block& b );
       void validate_transaction( const protocol::transaction& t );
 
+      rpc::chain::submit_block_response apply_block(
+         const protocol::block& block,
+         std::shared_ptr< const signature_cache > signatures,
+         const serialized_block* serialized,
+         uint64_t index_to,
+         std::chrono::system_clock::time_point now
+      );
+
       fork_data get_fork_data( state_db::shared_lock_ptr db_lock );
+
+      std::shared_ptr< const head_snapshot > get_head_snapshot() const;
+      pinned_head pin_head();
+      void unpin_head();
+      bool commit_waiting();
+
+      // Called with _commit_mutex held. Returns false without waiting if a snapshot is pinned, unless wait is set.
+      bool begin_commit( bool wait );
+      void end_commit();
+      void publish_head_snapshot( state_db::state_node_ptr node, std::shared_ptr< const protocol::block > block );
+
+      std::shared_ptr< execution_context_cache > get_execution_cache( const state_db::state_node_ptr& node );
+      void set_execution_cache( const state_db::state_node_ptr& node, std::shared_ptr< execution_context_cache > cache );
+      void prune_execution_caches( uint64_t revision );
 };
 
-controller_impl::controller_impl( uint64_t read_compute_bandwidth_limit, uint32_t syscall_bufsize ) :
+controller_impl::controller_impl( uint64_t read_compute_bandwidth_limit, uint32_t syscall_bufsize, const std::string& vm_backend_name, std::size_t module_cache_size ) :
    _read_compute_bandwidth_limit( read_compute_bandwidth_limit ),
-   _syscall_bufsize( syscall_bufsize )
+   _syscall_bufsize( syscall_bufsize ),
+   _worker_threads( std::max( 1u, std::thread::hardware_concurrency() ) ),
+   _worker_pool( _worker_threads )
 {
-   _vm_backend = vm_manager::get_vm_backend(); // Default is fizzy
-   KOINOS_ASSERT( _vm_backend, unknown_backend_exception, "could not get vm backend" );
-
-   _cached_head_block = std::make_shared< const protocol::block >( protocol::block() );
+   const auto& backend_name = vm_backend_name.empty() ? vm_manager::get_default_vm_backend_name() : vm_backend_name;
+   _vm_backend = vm_manager::get_vm_backend( backend_name, module_cache_size );
+   KOINOS_ASSERT( _vm_backend, unknown_backend_exception, "could not get vm backend: ${b}", ("b", backend_name) );
 
    _vm_backend->initialize();
    LOG(info) << "Initialized " << _vm_backend->backend_name() << " VM backend";
@@ -197,18 +299,236 @@ void controller_impl::open( const std::filesystem::path& p, const chain::genesis
       _db.reset( _db.get_unique_lock() );
    }
 
+   auto root = _db.get_root( _db.get_shared_lock() );
+
+   {
+      execution_context ctx( _vm_backend );
+      ctx.push_frame( stack_frame {
+         .call_privilege = privilege::kernel_mode
+      } );
+
+      ctx.set_state_node( root->create_anonymous_node() );
+      ctx.set_cache( get_execution_cache( root ) );
+      auto head_info = system_call::get_head_info( ctx );
+
+      _block_index.reset( indexed_block {
+         .id        = head_info.head_topology().id(),
+         .previous  = head_info.head_topology().previous(),
+         .height    = head_info.head_topology().height(),
+         .timestamp = head_info.head_block_time()
+      } );
+   }
+
    auto head = _db.get_head( _db.get_shared_lock() );
+   publish_head_snapshot( head, std::make_shared< const protocol::block >() );
    LOG(info) << "Opened database at block - Height: " << head->revision() << ", ID: " << head->id();
 }
 
 void controller_impl::close()
 {
+   if ( _block_store_writer )
+   {
+      _block_store_writer->flush( 5000ms );
+      _block_store_writer.reset();
+   }
+
+   // Pinned reads must finish before the database closes beneath them
+   std::unique_lock< std::mutex > commit_lock( _commit_mutex );
+   begin_commit( true );
+
+   std::atomic_store( &_head_snapshot, std::shared_ptr< const head_snapshot >() );
+
+   {
+      std::lock_guard< std::mutex > lock( _execution_caches_mutex );
+      _execution_caches.clear();
+   }
+
    _db.close( _db.get_unique_lock() );
+   end_commit();
+}
+
+std::shared_ptr< const controller_impl::head_snapshot > controller_impl::get_head_snapshot() const
+{
+   auto head = std::atomic_load( &_head_snapshot );
+   KOINOS_ASSERT( head, internal_error_exception, "error retrieving head block" );
+   return head;
+}
+
+controller_impl::pinned_head controller_impl::pin_head()
+{
+   std::unique_lock< std::mutex > lock( _pin_mutex );
+   _pin_cv.wait( lock, [&]() { return !_committing; } );
+
+   // Loaded under the pin lock, so a commit cannot squash the snapshot's nodes between loading and pinning it
+   auto head = get_head_snapshot();
+   _pins++;
+   lock.unlock();
+
+   return pinned_head {
+      .pin  = std::shared_ptr< void >( nullptr, [this]( void* ) { unpin_head(); } ),
+      .head = std::move( head )
+   };
+}
+
+void controller_impl::unpin_head()
+{
+   {
+      std::lock_guard< std::mutex > lock( _pin_mutex );
+      _pins--;
+   }
+
+   _pin_cv.notify_all();
+}
+
+bool controller_impl::commit_waiting()
+{
+   std::lock_guard< std::mutex > lock( _pin_mutex );
+   return _committing;
+}
+
+bool controller_impl::begin_commit( bool wait )
+{
+   std::unique_lock< std::mutex > lock( _pin_mutex );
+
+   if ( _pins && !wait )
+      return false;
+
+   // New pins wait from here, so the pinned reads drain
+   _committing = true;
+   _pin_cv.wait( lock, [&]() { return !_pins; } );
+   return true;
+}
+
+void controller_impl::end_commit()
+{
+   {
+      std::lock_guard< std::mutex > lock( _pin_mutex );
+      _committing = false;
+   }
+
+   _pin_cv.notify_all();
+}
+
+void controller_impl::publish_head_snapshot( state_db::state_node_ptr node, std::shared_ptr< const protocol::block > block )
+{
+   auto head = std::make_shared< head_snapshot >();
+   head->cache = get_execution_cache( node );
+
+   execution_context ctx( _vm_backend );
+   ctx.push_frame( stack_frame {
+      .call_privilege = privilege::kernel_mode
+   } );
+
+   ctx.set_state_node( node->create_anonymous_node() );
+   ctx.set_cache( head->cache );
+
+   // Without the head block, its time is read from state
+   if ( block->has_header() )
+      ctx.set_block( *block );
+
+   auto head_info = system_call::get_head_info( ctx );
+   *head->head_info.mutable_head_topology() = head_info.head_topology();
+   head->head_info.set_last_irreversible_block( head_info.last_irreversible_block() );
+   head->head_info.set_head_state_merkle_root( util::converter::as< std::string >( node->merkle_root() ) );
+   head->head_info.set_head_block_time( head_info.head_block_time() );
+   head->chain_id = system_call::get_chain_id( ctx );
+
+   if ( _read_contract_cache )
+      _read_contract_cache->set_head( util::converter::as< std::string >( node->id() ) );
+
+   head->node  = std::move( node );
+   head->block = std::move( block );
+   std::atomic_store( &_head_snapshot, std::shared_ptr< const head_snapshot >( std::move( head ) ) );
+}
+
+std::shared_ptr< execution_context_cache > controller_impl::get_execution_cache( const state_db::state_node_ptr& node )
+{
+   std::lock_guard< std::mutex > lock( _execution_caches_mutex );
+
+   auto& entry = _execution_caches[ util::converter::as< std::string >( node->id() ) ];
+   if ( !entry.second )
+      entry = std::make_pair( node->revision(), std::make_shared< execution_context_cache >() );
+
+   return entry.second;
+}
+
+void controller_impl::set_execution_cache( const state_db::state_node_ptr& node, std::shared_ptr< execution_context_cache > cache )
+{
+   std::lock_guard< std::mutex > lock( _execution_caches_mutex );
+   _execution_caches[ util::converter::as< std::string >( node->id() ) ] = std::make_pair( node->revision(), std::move( cache ) );
+}
+
+void controller_impl::prune_execution_caches( uint64_t revision )
+{
+   std::lock_guard< std::mutex > lock( _execution_caches_mutex );
+
+   for ( auto itr = _execution_caches.begin(); itr != _execution_caches.end(); )
+   {
+      if ( itr->second.first < revision )
+         itr = _execution_caches.erase( itr );
+      else
+         ++itr;
+   }
 }
 
 void controller_impl::set_client( std::shared_ptr< mq::client > c )
 {
+   _block_store_writer.reset();
    _client = c;
+
+   if ( _client )
+      _block_store_writer = std::make_unique< block_store_writer >( _client );
+}
+
+void controller_impl::set_block_store_writer( std::unique_ptr< block_store_writer > writer )
+{
+   _block_store_writer = std::move( writer );
+}
+
+void controller_impl::set_module_directory( const std::filesystem::path& p )
+{
+   // Module formats are backend specific, so every backend gets its own directory
+   _vm_backend->set_module_directory( p / _vm_backend->backend_name() );
+}
+
+void controller_impl::set_parallel_transactions( bool enabled )
+{
+   if ( enabled )
+      _parallel_executor = std::make_shared< parallel_executor >( _worker_pool );
+   else
+      _parallel_executor.reset();
+}
+
+void controller_impl::set_read_contract_cache_size( std::size_t entries )
+{
+   if ( entries )
+   {
+      _read_contract_cache = std::make_unique< read_contract_cache >( entries );
+
+      if ( auto head = std::atomic_load( &_head_snapshot ) )
+         _read_contract_cache->set_head( util::converter::as< std::string >( head->node->id() ) );
+   }
+   else
+   {
+      _read_contract_cache.reset();
+   }
+}
+
+void controller_impl::set_max_batch_size( std::size_t requests )
+{
+   _max_batch_size = requests;
+}
+
+void controller_impl::set_batch_threads( std::size_t threads )
+{
+   if ( _batch_pool )
+   {
+      _batch_pool->join();
+      _batch_pool.reset();
+   }
+
+   if ( threads )
+      _batch_pool = std::make_unique< boost::asio::thread_pool >( threads );
 }
 
 void controller_impl::validate_block( const protocol::block& b )
@@ -235,6 +555,20 @@ void controller_impl::validate_transaction( const protocol::transaction& t )
    KOINOS_ASSERT( t.signatures().size(), missing_required_arguments_exception, "missing expected field in transaction: ${field}", ("field", "signature_data")("transaction_id", util::to_hex( t.id() )) );
 }
 
+std::shared_ptr< const prepared_block > controller_impl::prepare_block( protocol::block&& block )
+{
+   validate_block( block );
+
+   auto prepared = std::make_shared< prepared_block >();
+   prepared->block = std::move( block );
+
+   // Callers prepare many blocks concurrently, so recover serially on the calling thread
+   prepared->signatures = recover_block_signatures( prepared->block, &_verified_signatures );
+   prepared->serialized = serialize_block( prepared->block );
+
+   return prepared;
+}
+
 rpc::chain::submit_block_response controller_impl::submit_block(
    const rpc::chain::submit_block_request& request,
    uint64_t index_to,
@@ -242,6 +576,24 @@ rpc::chain::submit_block_response controller_impl::submit_block(
 {
    validate_block( request.block() );
 
+   return apply_block( request.block(), {}, nullptr, index_to, now );
+}
+
+rpc::chain::submit_block_response controller_impl::submit_block(
+   const prepared_block& block,
+   uint64_t index_to,
+   std::chrono::system_clock::time_point now )
+{
+   return apply_block( block.block, block.signatures, &block.serialized, index_to, now );
+}
+
+rpc::chain::submit_block_response controller_impl::apply_block(
+   const protocol::block& block,
+   std::shared_ptr< const signature_cache > signatures,
+   const serialized_block* serialized,
+   uint64_t index_to,
+   std::chrono::system_clock::time_point now )
+{
    rpc::chain::submit_block_response resp;
 
    static constexpr uint64_t index_message_interval = 1000;
@@ -254,7 +606,6 @@ rpc::chain::submit_block_response controller_impl::submit_block(
 
    auto db_lock = _db.get_shared_lock();
 
-   const auto& block = request.block();
    auto block_id     = util::converter::to< crypto::multihash >( block.id() );
    auto block_height = block.header().height();
    auto parent_id    = util::converter::to< crypto::multihash >( block.header().previous() );
@@ -274,6 +625,9 @@ rpc::chain::submit_block_response controller_impl::submit_block(
       return {}; // Block is current LIB
    }
 
+   // Everything cached for the parent remains valid for this block until the block writes an object the cache depends on
+   auto parent_cache = get_execution_cache( parent_node );
+
    bool live = block.header().timestamp() > std::chrono::duration_cast< std::chrono::milliseconds >( ( now - live_delta ).time_since_epoch() ).count();
 
    if ( !index_to && live )
@@ -287,17 +641,27 @@ rpc::chain::submit_block_response controller_impl::submit_block(
    // than the parent block timestamp.
    if ( block_node && !parent_id.is_zero() )
    {
-      execution_context parent_ctx( _vm_backend, intent::read_only );
-
-      parent_ctx.push_frame( stack_frame {
-         .call_privilege = privilege::kernel_mode
-      } );
-
-      parent_ctx.set_state_node( parent_node );
-      parent_ctx.reset_cache();
-      auto head_info = system_call::get_head_info( parent_ctx );
-      parent_height = head_info.head_topology().height();
-      time_lower_bound = head_info.head_block_time();
+      if ( auto parent = _block_index.get( block.header().previous() ) )
+      {
+         parent_height    = parent->height;
+         time_lower_bound = parent->timestamp;
+      }
+      else
+      {
+         // A parent missing from the index falls back to reading its head block from state
+         execution_context parent_ctx( _vm_backend, intent::read_only );
+
+         parent_ctx.push_frame( stack_frame {
+            .call_privilege = privilege::kernel_mode
+         } );
+
+         // The context reads system objects from the grandparent, so it must not fill the parent's shared cache
+         parent_ctx.set_state_node( parent_node );
+         parent_ctx.reset_cache();
+         auto head_info = system_call::get_head_info( parent_ctx );
+         parent_height = head_info.head_topology().height();
+         time_lower_bound = head_info.head_block_time();
+      }
    }
 
    execution_context ctx( _vm_backend, intent::block_application );
@@ -332,26 +696,29 @@ rpc::chain::submit_block_response controller_impl::submit_block(
       } );
 
       ctx.set_state_node( block_node );
-      ctx.reset_cache();
+      ctx.set_cache( parent_cache );
+
+      // Recover all signatures up front on the worker pool. Compute is still charged when they are consumed.
+      if ( !signatures )
+         signatures = recover_block_signatures( block, _worker_pool, _worker_threads, &_verified_signatures );
+
+      ctx.set_signature_cache( std::move( signatures ) );
+      ctx.set_parallel_executor( _parallel_executor );
+      ctx.set_serialized_block( serialized );
 
       system_call::apply_block( ctx, block );
 
       KOINOS_ASSERT( std::holds_alternative< protocol::block_receipt >( ctx.receipt() ), unexpected_receipt_exception, "expected block receipt" );
       *resp.mutable_receipt() = std::get< protocol::block_receipt >( ctx.receipt() );
 
-      if ( _client )
+      // Blocks are added to the block store in the background, LIB waits for them below
+      if ( _block_store_writer )
       {
-         rpc::block_store::block_store_request req;
-         req.mutable_add_block()->mutable_block_to_add()->CopyFrom( block );
-         req.mutable_add_block()->mutable_receipt_to_add()->CopyFrom( std::get< protocol::block_receipt >( ctx.receipt() ) );
-
-         auto future = _client->rpc( util::service::block_store, util::converter::as< std::string >( req ), 1500ms, mq::retry_policy::none );
-
-         rpc::block_store::block_store_response resp;
-         resp.ParseFromString( future.get() );
-
-         KOINOS_ASSERT( !resp.has_error(), rpc_failure_exception, "received error from block store: ${e}", ("e", resp.error()) );
-         KOINOS_ASSERT( resp.has_add_block(), rpc_failure_exception, "unexpected response when submitting block: ${r}", ("r", resp) );
+         KOINOS_ASSERT(
+            _block_store_writer->add_block( block, std::get< protocol::block_receipt >( ctx.receipt() ), 1500ms ),
+            rpc_failure_exception,
+            "block store has not acknowledged ${n} blocks", ("n", default_block_store_backlog)
+         );
       }
 
       if ( !index_to && live )
@@ -375,34 +742,83 @@ rpc::chain::submit_block_response controller_impl::submit_block(
       }
 
       auto lib = system_call::get_last_irreversible_block( ctx );
+      const bool advance_lib = lib > _db.get_root( db_lock )->revision();
 
       try {
-         // We need to finalize our node, checking if it is the new head block, update the cached head block,
-         // and advancing LIB as an atomic action or else we risk _db.get_head(), _cached_head_block, and
+         // We need to finalize our node, checking if it is the new head block, publish the head snapshot,
+         // and advancing LIB as an atomic action or else we risk _db.get_head(), the head snapshot, and
          // LIB desyncing from each other
          db_lock.reset();
          block_node.reset();
          parent_node.reset();
          ctx.clear_state_node();
 
+         // Pinned reads do not hold the database lock, so only a commit waits for them. The commit is deferred
+         // while reads are pinned, until too many commits have been deferred. Taken before the database lock,
+         // because a pinned read may still be waiting for a shared lock.
+         std::unique_lock< std::mutex > commit_lock( _commit_mutex );
+
+         // Ends the commit before the commit mutex is released, including when an exception is thrown
+         std::shared_ptr< void > commit;
+         if ( advance_lib && begin_commit( _deferred_commits >= max_deferred_commits ) )
+            commit = std::shared_ptr< void >( nullptr, [this]( void* ) { end_commit(); } );
+
          auto unique_db_lock = _db.get_unique_lock();
          _db.finalize_node( block_id, unique_db_lock );
 
+         _block_index.add( indexed_block {
+            .id        = block.id(),
+            .previous  = block.header().previous(),
+            .height    = block_height,
+            .timestamp = block.header().timestamp()
+         } );
+
          resp.mutable_receipt()->set_state_merkle_root( util::converter::as< std::string >( _db.get_node( block_id, unique_db_lock )->merkle_root() ) );
 
-         if ( block_id == _db.get_head( unique_db_lock )->id() )
-         {
-            std::unique_lock< std::shared_mutex > head_lock( _cached_head_block_mutex );
-            new_head = true;
-            _cached_head_block = std::make_shared< protocol::block >( block );
-         }
+         new_head = block_id == _db.get_head( unique_db_lock )->id();
+
+         set_execution_cache(
+            _db.get_node( block_id, unique_db_lock ),
+            ctx.cache_stale() ? std::make_shared< execution_context_cache >() : parent_cache
+         );
+
+         const auto root_revision = _db.get_root( unique_db_lock )->revision();
 
-         if ( lib > _db.get_root( unique_db_lock )->revision() )
+         if ( lib > root_revision )
          {
             auto lib_id = _db.get_node_at_revision( lib, block_id, unique_db_lock )->id();
-            _db.commit_node( lib_id, unique_db_lock );
+
+            // Reversible blocks are lost on restart, so LIB only advances over blocks the block store has.
+            // Blocks are written in order, so once a block is acknowledged so are its ancestors.
+            if ( _block_store_writer )
+            {
+               while ( lib > root_revision && !_block_store_writer->acknowledged( util::converter::as< std::string >( lib_id ) ) )
+               {
+                  lib--;
+                  lib_id = _db.get_node_at_revision( lib, block_id, unique_db_lock )->id();
+               }
+            }
+
+            if ( lib > root_revision && commit )
+            {
+               _db.commit_node( lib_id, unique_db_lock );
+               _block_index.set_root( util::converter::as< std::string >( lib_id ) );
+               prune_execution_caches( lib );
+               _deferred_commits = 0;
+            }
+            else if ( lib > root_revision )
+            {
+               _deferred_commits++;
+            }
          }
 
+         // Republish before pins resume so no read pins a snapshot that references a node commit has replaced
+         publish_head_snapshot(
+            _db.get_head( unique_db_lock ),
+            new_head ? std::make_shared< const protocol::block >( block ) : get_head_snapshot()->block
+         );
+
+         commit.reset();
          unique_db_lock.reset();
          db_lock = _db.get_shared_lock();
          block_node = _db.get_node( block_id, db_lock );
@@ -528,21 +944,15 @@ rpc::chain::submit_transaction_response controller_impl::submit_transaction( con
 
    LOG(debug) << "Pushing transaction - ID: " << transaction_id;
 
-   auto db_lock = _db.get_shared_lock();
-   state_node_ptr head;
+   auto [ pin, head ] = pin_head();
    execution_context ctx( _vm_backend, intent::transaction_application );
-   std::shared_ptr< const protocol::block > head_block_ptr;
 
-   {
-      std::shared_lock< std::shared_mutex > head_lock( _cached_head_block_mutex );
-      head_block_ptr = _cached_head_block;
-      KOINOS_ASSERT( head_block_ptr, internal_error_exception, "error retrieving head block" );
+   ctx.set_block( *head->block );
+   ctx.set_state_node( head->node->create_anonymous_node() );
+   ctx.set_cache( head->cache );
 
-      head = _db.get_head( db_lock );
-   }
-
-   ctx.set_block( *head_block_ptr );
-   ctx.set_state_node( head->create_anonymous_node() );
+   // Keys recovered while applying the transaction are reused when it is applied in a block
+   ctx.set_verified_signatures( &_verified_signatures );
 
    ctx.push_frame( stack_frame {
       .call_privilege = privilege::kernel_mode
@@ -550,8 +960,6 @@ rpc::chain::submit_transaction_response controller_impl::submit_transaction( con
 
    try
    {
-      ctx.reset_cache();
-
       payer        = transaction.header().payer();
       max_payer_rc = system_call::get_account_rc( ctx, payer );
       trx_rc_limit = transaction.header().rc_limit();
@@ -613,115 +1021,53 @@ rpc::chain::submit_transaction_response controller_impl::submit_transaction( con
 
 rpc::chain::get_head_info_response controller_impl::get_head_info( const rpc::chain::get_head_info_request& )
 {
-   execution_context ctx( _vm_backend );
-   ctx.push_frame( stack_frame {
-      .call_privilege = privilege::kernel_mode
-   } );
-
-   auto db_lock = _db.get_shared_lock();
-   state_node_ptr head;
-   std::shared_ptr< const protocol::block > head_block_ptr;
-
-   {
-      std::shared_lock< std::shared_mutex > head_lock( _cached_head_block_mutex );
-      head_block_ptr = _cached_head_block;
-
-      KOINOS_ASSERT( head_block_ptr, internal_error_exception, "error retrieving head block" );
-
-      head = _db.get_head( db_lock );
-   }
-
-   ctx.set_state_node( head->create_anonymous_node() );
-
-   KOINOS_ASSERT( head_block_ptr, internal_error_exception, "error retrieving head block" );
-
-   ctx.set_block( *head_block_ptr );
-   ctx.reset_cache();
-
-   auto head_info = system_call::get_head_info( ctx );
-   block_topology topo = head_info.head_topology();
-
-   rpc::chain::get_head_info_response resp;
-   *resp.mutable_head_topology() = topo;
-   resp.set_last_irreversible_block( head_info.last_irreversible_block() );
-   resp.set_head_state_merkle_root( util::converter::as< std::string >( head->merkle_root() ) );
-   resp.set_head_block_time( head_info.head_block_time() );
-
-   return resp;
+   return get_head_snapshot()->head_info;
 }
 
 rpc::chain::get_chain_id_response controller_impl::get_chain_id( const rpc::chain::get_chain_id_request& )
 {
-   execution_context ctx( _vm_backend );
-   ctx.push_frame( stack_frame {
-      .call_privilege = privilege::kernel_mode
-   } );
-
-   ctx.set_state_node( _db.get_head( _db.get_shared_lock() )->create_anonymous_node() );
-   ctx.reset_cache();
-
    rpc::chain::get_chain_id_response resp;
-   resp.set_chain_id( system_call::get_chain_id( ctx ) );
-
+   resp.set_chain_id( get_head_snapshot()->chain_id );
    return resp;
 }
 
 fork_data controller_impl::get_fork_data( state_db::shared_lock_ptr db_lock )
 {
    fork_data fdata;
-   execution_context ctx( _vm_backend );
-
-   ctx.push_frame( koinos::chain::stack_frame {
-      .call_privilege = privilege::kernel_mode
-   } );
-
-   std::vector< state_db::state_node_ptr > fork_heads;
-
-   ctx.set_state_node( _db.get_root( db_lock )->create_anonymous_node() );
-   ctx.reset_cache();
-   fork_heads = _db.get_fork_heads( db_lock );
-
-   auto head_info = system_call::get_head_info( ctx );
-   fdata.second = head_info.head_topology();
-
-   for ( auto& fork : fork_heads )
-   {
-      ctx.set_state_node( fork->create_anonymous_node() );
-      ctx.reset_cache();
-      auto head_info = system_call::get_head_info( ctx );
-      fdata.first.emplace_back( std::move( head_info.head_topology() ) );
-   }
 
-   // Sort all fork heads by height
-   std::sort( fdata.first.begin(), fdata.first.end(), []( const block_topology& a, const block_topology& b )
+   auto to_topology = []( const indexed_block& b )
    {
-      return a.height() > b.height();
-   } );
+      block_topology topo;
+      topo.set_id( b.id );
+      topo.set_previous( b.previous );
+      topo.set_height( b.height );
+      return topo;
+   };
 
-   // If there is a tie for highest block, ensure the head block is first
-   auto fork_itr = fdata.first.begin();
-   while ( fork_itr != fdata.first.begin() && fork_itr->id() != head_info.head_topology().id() )
-   {
-      ++fork_itr;
-   }
+   fdata.second = to_topology( _block_index.root() );
 
-   if ( fork_itr != fdata.first.begin() )
-   {
-      std::iter_swap( fork_itr, fdata.first.begin() );
-   }
+   // Fork heads are sorted by height, and if there is a tie for highest block the head block is first
+   for ( const auto& fork_head : _block_index.fork_heads( util::converter::as< std::string >( _db.get_head( db_lock )->id() ) ) )
+      fdata.first.emplace_back( to_topology( fork_head ) );
 
    return fdata;
 }
 
-rpc::chain::get_resource_limits_response controller_impl::get_resource_limits( const rpc::chain::get_resource_limits_request& )
+rpc::chain::get_resource_limits_response controller_impl::get_resource_limits( const rpc::chain::get_resource_limits_request& request )
+{
+   auto pinned = pin_head();
+   return get_resource_limits( *pinned.head, request );
+}
+
+rpc::chain::get_resource_limits_response controller_impl::get_resource_limits( const head_snapshot& head, const rpc::chain::get_resource_limits_request& )
 {
    execution_context ctx( _vm_backend );
    ctx.push_frame( stack_frame {
       .call_privilege = privilege::kernel_mode
    } );
 
-   ctx.set_state_node( _db.get_head( _db.get_shared_lock() )->create_anonymous_node() );
-   ctx.reset_cache();
+   ctx.set_state_node( head.node->create_anonymous_node() );
+   ctx.set_cache( head.cache );
 
    auto value = system_call::get_resource_limits( ctx );
 
@@ -732,6 +1078,12 @@ rpc::chain::get_resource_limits_response controller_impl::get_resource_limits( c
 }
 
 rpc::chain::get_account_rc_response controller_impl::get_account_rc( const rpc::chain::get_account_rc_request& request )
+{
+   auto pinned = pin_head();
+   return get_account_rc( *pinned.head, request );
+}
+
+rpc::chain::get_account_rc_response controller_impl::get_account_rc( const head_snapshot& head, const rpc::chain::get_account_rc_request& request )
 {
    KOINOS_ASSERT( request.account().size(), missing_required_arguments_exception, "missing expected field: ${f}", ("f", "payer") );
 
@@ -740,8 +1092,8 @@ rpc::chain::get_account_rc_response controller_impl::get_account_rc( const rpc::
       .call_privilege = privilege::kernel_mode
    } );
 
-   ctx.set_state_node( _db.get_head( _db.get_shared_lock() )->create_anonymous_node() );
-   ctx.reset_cache();
+   ctx.set_state_node( head.node->create_anonymous_node() );
+   ctx.set_cache( head.cache );
 
    auto value = system_call::get_account_rc( ctx, request.account() );
 
@@ -769,28 +1121,37 @@ rpc::chain::get_fork_heads_response controller_impl::get_fork_heads( const rpc::
 }
 
 rpc::chain::read_contract_response controller_impl::read_contract( const rpc::chain::read_contract_request& request )
+{
+   auto pinned = pin_head();
+   return read_contract( *pinned.head, request );
+}
+
+rpc::chain::read_contract_response controller_impl::read_contract( const head_snapshot& head, const rpc::chain::read_contract_request& request )
 {
    KOINOS_ASSERT( request.contract_id().size(), missing_required_arguments_exception, "missing expected field: ${f}", ("f", "contract_id") );
 
-   auto db_lock = _db.get_shared_lock();
+   if ( _read_contract_cache )
+   {
+      return _read_contract_cache->get(
+         util::converter::as< std::string >( head.node->id() ),
+         request,
+         [&]() { return execute_read_contract( head, request ); }
+      );
+   }
+
+   return execute_read_contract( head, request );
+}
 
+rpc::chain::read_contract_response controller_impl::execute_read_contract( const head_snapshot& head, const rpc::chain::read_contract_request& request )
+{
    execution_context ctx( _vm_backend, intent::read_only );
    ctx.push_frame( stack_frame {
       .call_privilege = privilege::user_mode,
    } );
 
-   std::shared_ptr< const protocol::block > head_block_ptr;
-
-   {
-      std::shared_lock< std::shared_mutex > head_lock( _cached_head_block_mutex );
-      head_block_ptr = _cached_head_block;
-      KOINOS_ASSERT( head_block_ptr, internal_error_exception, "error retrieving head block" );
-
-      ctx.set_state_node( _db.get_head( db_lock )->create_anonymous_node() );
-   }
-
-   ctx.set_block( *head_block_ptr );
-   ctx.reset_cache();
+   ctx.set_state_node( head.node->create_anonymous_node() );
+   ctx.set_block( *head.block );
+   ctx.set_cache( head.cache );
 
    resource_limit_data rl;
    rl.set_compute_bandwidth_limit( _read_compute_bandwidth_limit );
@@ -817,6 +1178,12 @@ rpc::chain::read_contract_response controller_impl::read_contract( const rpc::ch
 }
 
 rpc::chain::get_account_nonce_response controller_impl::get_account_nonce( const rpc::chain::get_account_nonce_request& request )
+{
+   auto pinned = pin_head();
+   return get_account_nonce( *pinned.head, request );
+}
+
+rpc::chain::get_account_nonce_response controller_impl::get_account_nonce( const head_snapshot& head, const rpc::chain::get_account_nonce_request& request )
 {
    KOINOS_ASSERT( request.account().size(), missing_required_arguments_exception, "missing expected field: ${f}", ("f", "account") );
 
@@ -826,8 +1193,8 @@ rpc::chain::get_account_nonce_response controller_impl::get_account_nonce( const
       .call_privilege = privilege::kernel_mode
    } );
 
-   ctx.set_state_node( _db.get_head( _db.get_shared_lock() )->create_anonymous_node() );
-   ctx.reset_cache();
+   ctx.set_state_node( head.node->create_anonymous_node() );
+   ctx.set_cache( head.cache );
 
    auto nonce = system_call::get_account_nonce( ctx, request.account() );
 
@@ -838,6 +1205,12 @@ rpc::chain::get_account_nonce_response controller_impl::get_account_nonce( const
 }
 
 rpc::chain::invoke_system_call_response controller_impl::invoke_system_call( const rpc::chain::invoke_system_call_request& request )
+{
+   auto pinned = pin_head();
+   return invoke_system_call( *pinned.head, request );
+}
+
+rpc::chain::invoke_system_call_response controller_impl::invoke_system_call( const head_snapshot& head, const rpc::chain::invoke_system_call_request& request )
 {
    KOINOS_ASSERT(
       request.has_id() || request.has_name(),
@@ -861,8 +1234,8 @@ rpc::chain::invoke_system_call_response controller_impl::invoke_system_call( con
 
    ctx.push_frame( std::move( sframe ) );
 
-   ctx.set_state_node( _db.get_head( _db.get_shared_lock() )->create_anonymous_node() );
-   ctx.reset_cache();
+   ctx.set_state_node( head.node->create_anonymous_node() );
+   ctx.set_cache( head.cache );
 
    resource_limit_data rl;
    rl.set_compute_bandwidth_limit( _read_compute_bandwidth_limit );
@@ -894,10 +1267,118 @@ rpc::chain::invoke_system_call_response controller_impl::invoke_system_call( con
    return resp;
 }
 
+std::vector< rpc::chain::chain_response > controller_impl::batch( const std::vector< rpc::chain::chain_request >& requests, bool parallel )
+{
+   KOINOS_ASSERT(
+      requests.size() <= _max_batch_size,
+      request_rejected_exception,
+      "batch of ${n} requests exceeds the maximum batch size of ${m}", ("n", requests.size())("m", _max_batch_size)
+   );
+
+   // Every request reads the same head, so the batch holds one pin throughout
+   auto pinned = pin_head();
+   const auto& head = *pinned.head;
+   std::vector< rpc::chain::chain_response > responses( requests.size() );
+
+   // A commit that can no longer be deferred waits for the pin. Once one is waiting, requests that have not
+   // started fail instead, so the pin is held for at most one more request per thread.
+   auto execute = [&]( std::size_t i )
+   {
+      if ( commit_waiting() )
+         responses[ i ].mutable_error()->set_message( "Error: batch was interrupted by a block commit" );
+      else
+         execute_batch_request( head, requests[ i ], responses[ i ] );
+   };
+
+   if ( !parallel || !_batch_pool || requests.size() < 2 )
+   {
+      for ( std::size_t i = 0; i < requests.size(); i++ )
+         execute( i );
+
+      return responses;
+   }
+
+   std::vector< std::future< void > > pending;
+   pending.reserve( requests.size() );
+
+   for ( std::size_t i = 0; i < requests.size(); i++ )
+   {
+      auto done = std::make_shared< std::promise< void > >();
+      pending.emplace_back( done->get_future() );
+
+      boost::asio::post( *_batch_pool, [&, i, done]()
+      {
+         execute( i );
+         done->set_value();
+      } );
+   }
+
+   for ( auto& f : pending )
+      f.wait();
+
+   return responses;
+}
+
+void controller_impl::execute_batch_request( const head_snapshot& head, const rpc::chain::chain_request& request, rpc::chain::chain_response& response ) noexcept
+{
+   try
+   {
+      switch( request.request_case() )
+      {
+         case rpc::chain::chain_request::RequestCase::kGetHeadInfo:
+            *response.mutable_get_head_info() = head.head_info;
+            break;
+         case rpc::chain::chain_request::RequestCase::kGetChainId:
+            response.mutable_get_chain_id()->set_chain_id( head.chain_id );
+            break;
+         case rpc::chain::chain_request::RequestCase::kReadContract:
+            *response.mutable_read_contract() = read_contract( head, request.read_contract() );
+            break;
+         case rpc::chain::chain_request::RequestCase::kGetAccountNonce:
+            *response.mutable_get_account_nonce() = get_account_nonce( head, request.get_account_nonce() );
+            break;
+         case rpc::chain::chain_request::RequestCase::kGetAccountRc:
+            *response.mutable_get_account_rc() = get_account_rc( head, request.get_account_rc() );
+            break;
+         case rpc::chain::chain_request::RequestCase::kGetResourceLimits:
+            *response.mutable_get_resource_limits() = get_resource_limits( head, request.get_resource_limits() );
+            break;
+         case rpc::chain::chain_request::RequestCase::kInvokeSystemCall:
+            *response.mutable_invoke_system_call() = invoke_system_call( head, request.invoke_system_call() );
+            break;
+         default:
+            response.mutable_error()->set_message( "Error: attempted to call rpc that cannot be batched" );
+            break;
+      }
+   }
+   catch ( const koinos::exception& e )
+   {
+      auto error = response.mutable_error();
+      error->set_message( e.what() );
+
+      auto j = e.get_json();
+      j[ "code" ] = e.get_code();
+      error->set_data( j.dump() );
+   }
+   catch ( const std::exception& e )
+   {
+      auto error = response.mutable_error();
+      error->set_message( e.what() );
+
+      nlohmann::json j;
+      j[ "code" ] = internal_error;
+      error->set_data( j.dump() );
+   }
+   catch ( ... )
+   {
+      response.mutable_error()->set_message( "unexpected error while handling rpc" );
+   }
+}
+
 } // detail
 
-controller::controller( uint64_t read_compute_bandwith_limit, uint32_t syscall_bufsize ) :
-   _my( std::make_unique< detail::controller_impl >( read_compute_bandwith_limit, syscall_bufsize ) ) {}
+controller::controller( uint64_t read_compute_bandwith_limit, uint32_t syscall_bufsize, const std::string& vm_backend_name, std::size_t module_cache_size ) :
+   _my( std::make_unique< detail::controller_impl >( read_compute_bandwith_limit, syscall_bufsize, vm_backend_name, module_cache_size ) ) {}
 
 controller::~controller() = default;
 
@@ -916,6 +1397,36 @@ void controller::set_client( std::shared_ptr< mq::client > c )
    _my->set_client( c );
 }
 
+void controller::set_block_store_writer( std::unique_ptr< block_store_writer > writer )
+{
+   _my->set_block_store_writer( std::move( writer ) );
+}
+
+void controller::set_module_directory( const std::filesystem::path& p )
+{
+   _my->set_module_directory( p );
+}
+
+void controller::set_parallel_transactions( bool enabled )
+{
+   _my->set_parallel_transactions( enabled );
+}
+
+void controller::set_read_contract_cache_size( std::size_t entries )
+{
+   _my->set_read_contract_cache_size( entries );
+}
+
+void controller::set_max_batch_size( std::size_t requests )
+{
+   _my->set_max_batch_size( requests );
+}
+
+void controller::set_batch_threads( std::size_t threads )
+{
+   _my->set_batch_threads( threads );
+}
+
 rpc::chain::submit_block_response controller::submit_block(
    const rpc::chain::submit_block_request& request,
    uint64_t index_to,
@@ -924,6 +1435,19 @@ rpc::chain::submit_block_response controller::submit_block(
    return _my->submit_block( request, index_to, now );
 }
 
+rpc::chain::submit_block_response controller::submit_block(
+   const prepared_block& block,
+   uint64_t index_to,
+   std::chrono::system_clock::time_point now )
+{
+   return _my->submit_block( block, index_to, now );
+}
+
+std::shared_ptr< const prepared_block > controller::prepare_block( protocol::block&& block ) const
+{
+   return _my->prepare_block( std::move( block ) );
+}
+
 rpc::chain::submit_transaction_response controller::submit_transaction( const rpc::chain::submit_transaction_request& request )
 {
    return _my->submit_transaction( request );
@@ -969,5 +1493,10 @@ rpc::chain::invoke_system_call_response controller::invoke_system_call( const rp
    return _my->invoke_system_call( request );
 }
 
+std::vector< rpc::chain::chain_response > controller::batch( const std::vector< rpc::chain::chain_request >& requests, bool parallel )
+{
+   return _my->batch( requests, parallel );
+}
+
 
 } // koinos::chain
@@ -7,8 +7,32 @@
 
 namespace koinos::chain {
 
+const std::string& compute_cost_name( compute_cost c )
+{
+   static const std::array< std::string, static_cast< std::size_t >( compute_cost::num_costs ) > names = {
+      "deserialize_message_per_byte",
+      "object_serialization_per_byte",
+      "event_per_impacted",
+      "deserialize_multihash_base",
+      "deserialize_multihash_per_byte",
+      "sha1_base",
+      "sha1_per_byte",
+      "sha2_256_base",
+      "sha2_256_per_byte",
+      "sha2_512_base",
+      "sha2_512_per_byte",
+      "keccak_256_base",
+      "keccak_256_per_byte",
+      "ripemd_160_base",
+      "ripemd_160_per_byte"
+   };
+
+   return names.at( static_cast< std::size_t >( c ) );
+}
+
 execution_context::execution_context( std::shared_ptr< vm_manager::vm_backend > vm_backend, chain::intent i ) :
-   _vm_backend( vm_backend )
+   _vm_backend( vm_backend ),
+   _cache( std::make_shared< execution_context_cache >() )
 {
    set_intent( i );
 }
@@ -61,6 +85,24 @@ void execution_context::clear_block()
    _block = nullptr;
 }
 
+void execution_context::set_serialized_block( const chain::serialized_block* serialized )
+{
+   _serialized_block = serialized;
+}
+
+const chain::serialized_block* execution_context::get_serialized_block() const
+{
+   return _serialized_block;
+}
+
+const chain::serialized_transaction* execution_context::get_serialized_transaction( const protocol::transaction& trx ) const
+{
+   if ( !_serialized_block )
+      return nullptr;
+
+   return _serialized_block->find( trx );
+}
+
 void execution_context::set_transaction( const protocol::transaction& trx )
 {
    _trx = &trx;
@@ -91,6 +133,46 @@ void execution_context::clear_operation()
    _op = nullptr;
 }
 
+void execution_context::set_signature_cache( std::shared_ptr< const chain::signature_cache > cache )
+{
+   _signature_cache = cache;
+}
+
+std::shared_ptr< const chain::signature_cache > execution_context::signature_cache() const
+{
+   return _signature_cache;
+}
+
+void execution_context::set_verified_signatures( verified_signature_cache* verified )
+{
+   _verified_signatures = verified;
+}
+
+verified_signature_cache* execution_context::verified_signatures() const
+{
+   return _verified_signatures;
+}
+
+void execution_context::set_state_access( std::shared_ptr< state_access_set > access )
+{
+   _state_access = access;
+}
+
+state_access_set* execution_context::state_access() const
+{
+   return _state_access.get();
+}
+
+void execution_context::set_parallel_executor( std::shared_ptr< chain::parallel_executor > executor )
+{
+   _parallel_executor = executor;
+}
+
+chain::parallel_executor* execution_context::parallel_executor() const
+{
+   return _parallel_executor.get();
+}
+
 const std::string& execution_context::get_contract_call_args() const
 {
    KOINOS_ASSERT( _stack.size() > 1, chain::internal_error_exception, "stack is empty" );
@@ -204,6 +286,11 @@ chain::intent execution_context::intent() const
 
 void execution_context::build_compute_registry_cache()
 {
+   std::lock_guard< std::mutex > lock( _cache->build_mutex );
+
+   if ( _cache->compute_bandwidth_ready )
+      return;
+
    auto parent_state_node = get_parent_node();
    KOINOS_ASSERT( parent_state_node, chain::reversion_exception, "cannot build execution context cache without a state node" );
 
@@ -211,13 +298,33 @@ void execution_context::build_compute_registry_cache()
    KOINOS_ASSERT( obj, chain::reversion_exception, "compute bandwidth registry does not exist" );
    auto compute_registry = util::converter::to< compute_bandwidth_registry >( *obj );
 
-   _cache.compute_bandwidth.emplace();
    for ( const auto& entry : compute_registry.entries() )
-      ( *_cache.compute_bandwidth )[ entry.name() ] = entry.compute();
+      _cache->compute_bandwidth[ entry.name() ] = entry.compute();
+
+   const auto* desc = chain::system_call_id_descriptor();
+   for ( int i = 0; i < desc->value_count(); i++ )
+   {
+      const auto* value = desc->value( i );
+      if ( auto itr = _cache->compute_bandwidth.find( value->name() ); itr != _cache->compute_bandwidth.end() )
+         _cache->compute_costs.thunks[ value->number() ] = itr->second;
+   }
+
+   for ( std::size_t i = 0; i < _cache->compute_costs.named.size(); i++ )
+   {
+      if ( auto itr = _cache->compute_bandwidth.find( compute_cost_name( compute_cost( i ) ) ); itr != _cache->compute_bandwidth.end() )
+         _cache->compute_costs.named[ i ] = itr->second;
+   }
+
+   _cache->compute_bandwidth_ready.store( true, std::memory_order_release );
 }
 
 void execution_context::build_descriptor_pool()
 {
+   std::lock_guard< std::mutex > lock( _cache->build_mutex );
+
+   if ( _cache->descriptor_pool_ready )
+      return;
+
    auto parent_state_node = get_parent_node();
    KOINOS_ASSERT( parent_state_node, chain::reversion_exception, "cannot build execution context cache without a state node" );
 
@@ -227,19 +334,39 @@ void execution_context::build_descriptor_pool()
    google::protobuf::FileDescriptorSet fdesc;
    KOINOS_ASSERT( fdesc.ParseFromString( *pdesc ), chain::reversion_exception, "file descriptor set is malformed" );
 
-   _cache.descriptor_pool.emplace();
+   _cache->descriptor_pool.emplace();
    for ( const auto& fd : fdesc.file() )
-      _cache.descriptor_pool->BuildFile( fd );
+      _cache->descriptor_pool->BuildFile( fd );
+
+   _cache->descriptor_pool_ready.store( true, std::memory_order_release );
+}
+
+const system_call_cache_entry& execution_context::resolve_system_call( uint32_t id )
+{
+   if ( id < _cache->system_call_table.size() )
+   {
+      if ( const auto* entry = _cache->system_call_table[ id ].load( std::memory_order_acquire ) )
+         return *entry;
+   }
+   else
+   {
+      std::shared_lock< std::shared_mutex > lock( _cache->system_call_mutex );
+
+      // Entries are never erased, so references remain valid after the lock is released
+      auto itr = _cache->system_call_entries.find( id );
+      if ( itr != _cache->system_call_entries.end() )
+         return itr->second;
+   }
+
+   return cache_system_call( id );
 }
 
-void execution_context::cache_system_call( uint32_t id )
+const system_call_cache_entry& execution_context::cache_system_call( uint32_t id )
 {
    auto parent_state_node = get_parent_node();
    KOINOS_ASSERT( parent_state_node, chain::reversion_exception, "cannot build execution context cache without a state node" );
 
-   if ( _cache.system_call_table.find( id ) != _cache.system_call_table.end() )
-      return;
-
+   std::optional< system_call_cache_entry > entry;
    auto obj = parent_state_node->get_object( state::space::system_call_dispatch(), util::converter::as< std::string >( id ) );
 
    if ( obj != nullptr )
@@ -256,138 +383,185 @@ void execution_context::cache_system_call( uint32_t id )
          KOINOS_ASSERT( contract_meta, invalid_contract_exception, "contract metadata for call id ${id} not found", ("id", id) );
          KOINOS_ASSERT( contract_bytecode, invalid_contract_exception, "contract bytecode for call id ${id} not found", ("id", id) );
 
-         auto success = _cache.system_call_table.emplace(
-            id,
+         entry.emplace(
             system_call_cache_bundle {
                contract_id,
                *contract_bytecode,
                entry_point,
                util::converter::to< chain::contract_metadata_object >( *contract_meta )
             }
-         ).second;
-         KOINOS_ASSERT( success, internal_error_exception, "caching system call ${id} failed", ("id", id) );
+         );
       }
       else
       {
-         auto success = _cache.system_call_table.emplace( id, thunk_cache_bundle { system_call_target.thunk_id(), true } ).second;
-         KOINOS_ASSERT( success, internal_error_exception, "caching system call ${id} failed", ("id", id) );
+         entry.emplace( thunk_cache_bundle { system_call_target.thunk_id(), true } );
       }
    }
    else
    {
-      auto success = _cache.system_call_table.emplace( id, thunk_cache_bundle { id, false } ).second;
-      KOINOS_ASSERT( success, internal_error_exception, "caching system call ${id} failed", ("id", id) );
+      entry.emplace( thunk_cache_bundle { id, false } );
    }
+
+   // Another context may have cached the same id in the meantime. Both read the same state, so either entry is correct.
+   std::unique_lock< std::shared_mutex > lock( _cache->system_call_mutex );
+   const auto& cached = _cache->system_call_entries.emplace( id, std::move( *entry ) ).first->second;
+
+   if ( id < _cache->system_call_table.size() )
+      _cache->system_call_table[ id ].store( &cached, std::memory_order_release );
+
+   return cached;
 }
 
 void execution_context::build_block_hash_code_cache()
 {
+   std::lock_guard< std::mutex > lock( _cache->build_mutex );
+
+   if ( _cache->block_hash_code_ready )
+      return;
+
    auto parent_state_node = get_parent_node();
    KOINOS_ASSERT( parent_state_node, reversion_exception, "cannot build execution context cache without a state node" );
 
    auto bhash = parent_state_node->get_object( state::space::metadata(), state::key::block_hash_code );
    KOINOS_ASSERT( bhash, invalid_contract_exception, "block hash code does not exist" );
 
-   _cache.block_hash_code.emplace( crypto::multicodec( util::converter::to< unsigned_varint >( *bhash ).value ) );
+   _cache->block_hash_code = crypto::multicodec( util::converter::to< unsigned_varint >( *bhash ).value );
+   _cache->block_hash_code_ready.store( true, std::memory_order_release );
 }
 
 void execution_context::reset_cache()
 {
-   _cache.compute_bandwidth.reset();
-   _cache.descriptor_pool.reset();
-   _cache.system_call_table.clear();
-   _cache.block_hash_code.reset();
+   _cache = std::make_shared< execution_context_cache >();
+}
+
+void execution_context::set_cache( std::shared_ptr< execution_context_cache > cache )
+{
+   KOINOS_ASSERT( cache, internal_error_exception, "execution context cache cannot be null" );
+   _cache = cache;
+}
+
+std::shared_ptr< execution_context_cache > execution_context::cache() const
+{
+   return _cache;
+}
+
+void execution_context::mark_cache_stale()
+{
+   _cache_stale = true;
+}
+
+bool execution_context::cache_stale() const
+{
+   return _cache_stale;
 }
 
 uint64_t execution_context::get_compute_bandwidth( const std::string& thunk_name )
 {
-   if ( !_cache.compute_bandwidth )
+   if ( !_cache->compute_bandwidth_ready.load( std::memory_order_acquire ) )
       build_compute_registry_cache();
 
-   auto itr = _cache.compute_bandwidth->find( thunk_name );
+   auto itr = _cache->compute_bandwidth.find( thunk_name );
 
-   KOINOS_ASSERT( itr != _cache.compute_bandwidth->end(), reversion_exception, "unable to find compute bandwidth for ${t}", ("t", thunk_name) );
+   KOINOS_ASSERT( itr != _cache->compute_bandwidth.end(), reversion_exception, "unable to find compute bandwidth for ${t}", ("t", thunk_name) );
 
    return itr->second;
 }
 
+const compute_cost_table& execution_context::compute_costs()
+{
+   if ( !_cache->compute_bandwidth_ready.load( std::memory_order_acquire ) )
+      build_compute_registry_cache();
+
+   return _cache->compute_costs;
+}
+
+uint64_t execution_context::get_compute_bandwidth( compute_cost c )
+{
+   const auto& cost = compute_costs().named[ static_cast< std::size_t >( c ) ];
+
+   KOINOS_ASSERT( cost, reversion_exception, "unable to find compute bandwidth for ${t}", ("t", compute_cost_name( c )) );
+
+   return *cost;
+}
+
+uint64_t execution_context::get_thunk_compute_bandwidth( uint32_t thunk_id )
+{
+   const auto& costs = compute_costs().thunks;
+
+   if ( thunk_id < costs.size() && costs[ thunk_id ] )
+      return *costs[ thunk_id ];
+
+   KOINOS_ASSERT( system_call_id_IsValid( thunk_id ), unknown_thunk_exception, "unrecognized thunk id ${id}", ("id", thunk_id) );
+   KOINOS_THROW( reversion_exception, "unable to find compute bandwidth for ${t}", ("t", system_call_id_Name( system_call_id( thunk_id ) )) );
+}
+
 const google::protobuf::DescriptorPool& execution_context::descriptor_pool()
 {
-   if ( !_cache.descriptor_pool )
+   if ( !_cache->descriptor_pool_ready.load( std::memory_order_acquire ) )
       build_descriptor_pool();
 
-   return *_cache.descriptor_pool;
+   return *_cache->descriptor_pool;
 }
 
 const execution_result& execution_context::system_call( uint32_t id, const std::string& args )
 {
-   try
-   {
-      cache_system_call( id );
-
-      auto itr = _cache.system_call_table.find( id );
-      KOINOS_ASSERT( itr != _cache.system_call_table.end(), reversion_exception, "unable to find call id ${id} in system call cache", ("id", id) );
-
-      const auto* call_bundle = std::get_if< system_call_cache_bundle >( &itr->second );
-      KOINOS_ASSERT( call_bundle, reversion_exception, "system call ${id} is implemented via thunk", ("id", id) );
-
-      with_stack_frame(
-         *this,
-         stack_frame {
-            .contract_id = call_bundle->contract_id,
-            .call_privilege = call_bundle->contract_metadata.system() ? privilege::kernel_mode : privilege::user_mode,
-            .call_args = args,
-            .entry_point = call_bundle->entry_point
-         },
-         [&]
-         {
-            chain::host_api hapi( *this );
-            get_backend()->run( hapi, call_bundle->contract_bytecode, call_bundle->contract_metadata.hash() );
-         }
-      );
-   }
-   catch ( const success_exception& ) {}
+   const auto* call_bundle = std::get_if< system_call_cache_bundle >( &resolve_system_call( id ) );
+   KOINOS_ASSERT( call_bundle, reversion_exception, "system call ${id} is implemented via thunk", ("id", id) );
 
-   return get_result();
+   return system_call( *call_bundle, args );
 }
 
-bool execution_context::system_call_exists( uint32_t id )
+const execution_result& execution_context::system_call( const system_call_cache_bundle& target, const std::string& args )
 {
-   cache_system_call( id );
+   with_stack_frame(
+      *this,
+      stack_frame {
+         .contract_id = target.contract_id,
+         .call_privilege = target.contract_metadata.system() ? privilege::kernel_mode : privilege::user_mode,
+         .call_args = args,
+         .entry_point = target.entry_point
+      },
+      [&]
+      {
+         chain::host_api hapi( *this );
+         get_backend()->run( hapi, target.contract_bytecode, target.contract_metadata.hash() );
+      }
+   );
 
-   auto itr = _cache.system_call_table.find( id );
-   if ( itr == _cache.system_call_table.end() )
-      return false;
+   return get_result();
+}
 
-   return std::get_if< system_call_cache_bundle >( &itr->second ) != nullptr;
+bool execution_context::system_call_exists( uint32_t id )
+{
+   return std::get_if< system_call_cache_bundle >( &resolve_system_call( id ) ) != nullptr;
 }
 
 uint32_t execution_context::thunk_translation( uint32_t id )
 {
-   cache_system_call( id );
-
-   auto itr = _cache.system_call_table.find( id );
-   KOINOS_ASSERT( itr != _cache.system_call_table.end(), reversion_exception, "unable to find call id ${id} in system call cache", ("id", id) );
-
-   const auto* thunk_bundle = std::get_if< thunk_cache_bundle >( &itr->second );
+   const auto* thunk_bundle = std::get_if< thunk_cache_bundle >( &resolve_system_call( id ) );
    KOINOS_ASSERT( thunk_bundle, reversion_exception, "system call ${id} is implemented via contract override", ("id", id) );
 
-   if ( thunk_bundle->is_override )
+   return thunk_translation( id, *thunk_bundle );
+}
+
+uint32_t execution_context::thunk_translation( uint32_t id, const thunk_cache_bundle& target )
+{
+   if ( target.is_override )
    {
-      return thunk_bundle->thunk_id;
+      return target.thunk_id;
    }
 
-   KOINOS_ASSERT( thunk_bundle->thunk_id == id, internal_error_exception, "non-override cached thunk id ${cached} does not match id ${id}", ("cached", thunk_bundle->thunk_id)("id", id) );
+   KOINOS_ASSERT( target.thunk_id == id, internal_error_exception, "non-override cached thunk id ${cached} does not match id ${id}", ("cached", target.thunk_id)("id", id) );
    KOINOS_ASSERT( thunk_dispatcher::instance().thunk_is_genesis( id ), unknown_thunk_exception, "thunk ${id} is not enabled", ("id", id) );
    return id;
 }
 
 const crypto::multicodec& execution_context::block_hash_code()
 {
-   if ( !_cache.block_hash_code )
+   if ( !_cache->block_hash_code_ready.load( std::memory_order_acquire ) )
       build_block_hash_code_cache();
 
-   return *_cache.block_hash_code;
+   return _cache->block_hash_code;
 }
 
 void execution_context::set_result( const execution_result& r )
@@ -40,7 +40,8 @@ int32_t host_api::invoke_thunk( uint32_t tid, char* ret_ptr, uint32_t ret_len, c
       if ( code <= chain::failure )
          throw failure_exception( code, error );
 
-      throw success_exception( code );
+      _exited = true;
+      return code;
    }
 
    if ( code != chain::success )
@@ -74,10 +75,12 @@ void host_api::call( uint32_t sid, char* ret_ptr, uint32_t ret_len, const char*
          .call_privilege = privilege::kernel_mode
       },
       [&]() {
-         if ( _ctx.system_call_exists( sid ) )
+         const auto& target = _ctx.resolve_system_call( sid );
+
+         if ( const auto* call_bundle = std::get_if< system_call_cache_bundle >( &target ) )
          {
             std::string args( arg_ptr, arg_len );
-            auto exec_res = _ctx.system_call( sid, args );
+            auto exec_res = _ctx.system_call( *call_bundle, args );
 
             if ( exec_res.res.has_object() )
             {
@@ -89,13 +92,9 @@ void host_api::call( uint32_t sid, char* ret_ptr, uint32_t ret_len, const char*
          }
          else
          {
-            auto thunk_id = _ctx.thunk_translation( sid );
+            auto thunk_id = _ctx.thunk_translation( sid, std::get< thunk_cache_bundle >( target ) );
             KOINOS_ASSERT( thunk_dispatcher::instance().thunk_exists( thunk_id ), unknown_thunk_exception, "thunk ${tid} does not exist", ("tid", thunk_id) );
-            auto desc = chain::system_call_id_descriptor();
-            auto enum_value = desc->FindValueByNumber( thunk_id );
-            KOINOS_ASSERT( enum_value, unknown_thunk_exception, "unrecognized thunk id ${id}", ("id", thunk_id) );
-            auto compute = _ctx.get_compute_bandwidth( enum_value->name() );
-            _ctx.resource_meter().use_compute_bandwidth( compute );
+            _ctx.resource_meter().use_compute_bandwidth( _ctx.get_thunk_compute_bandwidth( thunk_id ) );
             thunk_dispatcher::instance().call_thunk( thunk_id, _ctx, ret_ptr, ret_len, arg_ptr, arg_len, bytes_written );
          }
       }
@@ -127,7 +126,8 @@ int32_t host_api::invoke_system_call( uint32_t sid, char* ret_ptr, uint32_t ret_
       if ( code <= failure )
          throw failure_exception( code, error );
 
-      throw success_exception();
+      _exited = true;
+      return code;
    }
 
    if ( code != chain::success )
@@ -175,4 +175,9 @@ void host_api::use_meter_ticks( uint64_t meter_ticks )
    }
 }
 
+bool host_api::exited() const
+{
+   return _exited;
+}
+
 } // koinos::chain
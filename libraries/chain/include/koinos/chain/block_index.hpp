@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace koinos::chain {
+
+struct indexed_block
+{
+   std::string id;
+   std::string previous;
+   uint64_t    height    = 0;
+   uint64_t    timestamp = 0;
+};
+
+/**
+ * An in-memory index of the headers of every block between the last irreversible block and the
+ * fork heads, so looking up a block's height and time or the fork heads never touches state.
+ *
+ * Blocks are added as they are finalized and pruned as the root advances. A fork head is an
+ * indexed block without indexed children. Ids are serialized multihashes.
+ */
+class block_index final
+{
+   public:
+      void reset( const indexed_block& root );
+      void add( const indexed_block& block );
+
+      // Makes the block the root, pruning its ancestors and every block not descended from it
+      void set_root( const std::string& id );
+
+      std::optional< indexed_block > get( const std::string& id ) const;
+      indexed_block root() const;
+
+      // Returns the fork heads ordered by height, highest first. Among heads of the same height, head_id is first.
+      std::vector< indexed_block > fork_heads( const std::string& head_id = std::string() ) const;
+
+      std::size_t size() const;
+
+   private:
+      struct entry
+      {
+         indexed_block block;
+         std::size_t   children = 0;
+      };
+
+      mutable std::shared_mutex                  _mutex;
+      std::unordered_map< std::string, entry >   _blocks;
+      std::unordered_set< std::string >          _heads;
+      std::string                                _root;
+};
+
+} // koinos::chain
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <koinos/mq/client.hpp>
+#include <koinos/protocol/protocol.pb.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+#include <thread>
+
+namespace koinos::chain {
+
+constexpr std::size_t default_block_store_backlog = 256;
+
+/**
+ * Adds applied blocks to the block store in the background, in the order they were applied.
+ *
+ * Blocks are sent one at a time so the block store sees parents before their children. At most
+ * max_backlog blocks may be unacknowledged.
+ *
+ * Reversible blocks are only held in memory, so callers must not make a block irreversible
+ * until it has been acknowledged. A block that is lost from the queue is then applied and
+ * queued again after a restart.
+ *
+ * Only transport failures and timeouts are retried. If the block store responds with an error,
+ * no later block can be written, so the writer fails and refuses every block after it.
+ */
+class block_store_writer final
+{
+   public:
+      // Sends a serialized block store request and returns the serialized response, throwing if it was not delivered
+      using send_function = std::function< std::string( const std::string& ) >;
+
+      block_store_writer( std::shared_ptr< mq::client > client, std::size_t max_backlog = default_block_store_backlog );
+      block_store_writer( send_function send, std::size_t max_backlog = default_block_store_backlog );
+      ~block_store_writer();
+
+      // Queues the block, waiting up to timeout for room in the backlog. Returns false if the block was not queued.
+      // Throws rpc_failure_exception once the block store has rejected a block.
+      bool add_block( const protocol::block& block, const protocol::block_receipt& receipt, std::chrono::milliseconds timeout );
+
+      // Returns true if the block store has acknowledged the block or the block was never queued
+      bool acknowledged( const std::string& block_id ) const;
+
+      // Waits for every queued block to be acknowledged, returns false if the timeout expires or the writer fails first
+      bool flush( std::chrono::milliseconds timeout );
+
+      // The reason the writer failed, if the block store rejected a block
+      std::optional< std::string > error() const;
+
+      void stop();
+
+   private:
+      struct pending_block
+      {
+         std::string id;
+         uint64_t    height;
+         std::string request;
+      };
+
+      enum class write_result
+      {
+         written,
+         retry,
+         rejected
+      };
+
+      void run();
+      write_result write( const pending_block& block, std::string& error );
+
+      send_function                     _send;
+      std::size_t                       _max_backlog;
+
+      mutable std::mutex                _mutex;
+      std::condition_variable           _queued;
+      std::condition_variable           _acknowledged;
+      std::deque< pending_block >       _queue;
+      std::set< std::string >           _unacknowledged;
+      bool                              _stopping = false;
+      std::optional< std::string >      _error;
+
+      std::thread                       _thread;
+};
+
+} // koinos::chain
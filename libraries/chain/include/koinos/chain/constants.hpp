@@ -10,3 +10,10 @@ constexpr uint64_t default_irreversible_threshold = 60;
 constexpr uint32_t authorize_entrypoint = 0x4a2dbd90;
 
 } // koinos::chain
+
+namespace koinos::util::service {
+
+// Batched chain requests, served next to util::service::chain
+constexpr const char* chain_batch = "chain_batch";
+
+} // koinos::util::service
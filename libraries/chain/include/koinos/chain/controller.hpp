@@ -1,21 +1,28 @@
 #pragma once
 
+#include <koinos/chain/block_store_writer.hpp>
 #include <koinos/chain/constants.hpp>
+#include <koinos/chain/prepared_block.hpp>
 #include <koinos/mq/client.hpp>
 #include <koinos/protocol/protocol.pb.h>
 #include <koinos/rpc/chain/chain_rpc.pb.h>
 #include <koinos/state_db/state_db_types.hpp>
+#include <koinos/vm_manager/vm_backend.hpp>
 
 #include <any>
 #include <chrono>
 #include <filesystem>
 #include <map>
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace koinos::chain {
 
 namespace detail { class controller_impl; }
 
+constexpr std::size_t default_max_batch_size = 64;
+
 enum class fork_resolution_algorithm
 {
    fifo,
@@ -26,18 +33,37 @@ enum class fork_resolution_algorithm
 class controller final
 {
    public:
-      controller( uint64_t read_compute_bandwith_limit = 0, uint32_t syscall_bufsize = 0 );
+      controller(
+         uint64_t read_compute_bandwith_limit = 0,
+         uint32_t syscall_bufsize = 0,
+         const std::string& vm_backend_name = std::string(),
+         std::size_t module_cache_size = vm_manager::default_module_cache_size
+      );
       ~controller();
 
       void open( const std::filesystem::path& p, const chain::genesis_data& data, fork_resolution_algorithm algo, bool reset );
       void close();
       void set_client( std::shared_ptr< mq::client > c );
+      // Replaces the block store writer created by set_client
+      void set_block_store_writer( std::unique_ptr< block_store_writer > writer );
+      void set_module_directory( const std::filesystem::path& p );
+      void set_parallel_transactions( bool enabled );
+      void set_read_contract_cache_size( std::size_t entries );
+      void set_max_batch_size( std::size_t requests );
+      // The threads that execute parallel batches, 0 to execute batches sequentially
+      void set_batch_threads( std::size_t threads );
 
       rpc::chain::submit_block_response submit_block(
          const rpc::chain::submit_block_request&,
          uint64_t index_to = 0,
          std::chrono::system_clock::time_point now = std::chrono::system_clock::now()
       );
+      rpc::chain::submit_block_response submit_block(
+         const prepared_block&,
+         uint64_t index_to = 0,
+         std::chrono::system_clock::time_point now = std::chrono::system_clock::now()
+      );
+      std::shared_ptr< const prepared_block > prepare_block( protocol::block&& ) const;
       rpc::chain::submit_transaction_response submit_transaction( const rpc::chain::submit_transaction_request& );
       rpc::chain::get_head_info_response get_head_info( const rpc::chain::get_head_info_request&  = {} );
       rpc::chain::get_chain_id_response get_chain_id( const rpc::chain::get_chain_id_request&   = {} );
@@ -48,6 +74,15 @@ class controller final
       rpc::chain::get_resource_limits_response get_resource_limits( const rpc::chain::get_resource_limits_request& );
       rpc::chain::invoke_system_call_response invoke_system_call( const rpc::chain::invoke_system_call_request& );
 
+      /**
+       * Executes read requests against a single head block and returns their responses in order.
+       * Each response holds either the result or the error of its request. Requests that are not
+       * reads fail without being executed. With parallel set, requests execute concurrently on the
+       * batch threads. Throws request_rejected_exception if the batch exceeds the maximum batch size.
+       * If a block commit is waiting on the batch, requests that have not started fail with an error.
+       */
+      std::vector< rpc::chain::chain_response > batch( const std::vector< rpc::chain::chain_request >& requests, bool parallel = false );
+
    private:
       std::unique_ptr< detail::controller_impl > _my;
 };
@@ -36,6 +36,7 @@ KOINOS_DECLARE_DERIVED_EXCEPTION_WITH_CODE( block_state_error_exception, failure
 KOINOS_DECLARE_DERIVED_EXCEPTION_WITH_CODE( state_merkle_mismatch_exception, failure_exception, state_merkle_mismatch );
 KOINOS_DECLARE_DERIVED_EXCEPTION_WITH_CODE( unexpected_receipt_exception, failure_exception, unexpected_receipt );
 KOINOS_DECLARE_DERIVED_EXCEPTION_WITH_CODE( rpc_failure_exception, failure_exception, rpc_failure );
+KOINOS_DECLARE_DERIVED_EXCEPTION_WITH_CODE( request_rejected_exception, failure_exception, rpc_failure );
 KOINOS_DECLARE_DERIVED_EXCEPTION_WITH_CODE( pending_state_error_exception, failure_exception, pending_state_error );
 KOINOS_DECLARE_DERIVED_EXCEPTION_WITH_CODE( timestamp_out_of_bounds_exception, failure_exception, timestamp_out_of_bounds );
 KOINOS_DECLARE_DERIVED_EXCEPTION_WITH_CODE( indexer_failure_exception, failure_exception, indexer_failure );
@@ -4,8 +4,10 @@
 
 #include <koinos/chain/chronicler.hpp>
 #include <koinos/chain/exceptions.hpp>
+#include <koinos/chain/prepared_block.hpp>
 #include <koinos/chain/resource_meter.hpp>
 #include <koinos/chain/session.hpp>
+#include <koinos/chain/signature_cache.hpp>
 #include <koinos/crypto/elliptic.hpp>
 #include <koinos/state_db/state_db.hpp>
 #include <koinos/vm_manager/vm_backend.hpp>
@@ -14,9 +16,13 @@
 #include <koinos/chain/system_call_ids.pb.h>
 #include <koinos/protocol/protocol.pb.h>
 
+#include <array>
+#include <atomic>
 #include <deque>
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <shared_mutex>
 #include <string>
 #include <tuple>
 #include <utility>
@@ -33,6 +39,10 @@ using koinos::state_db::anonymous_state_node_ptr;
 using koinos::state_db::abstract_state_node;
 
 using abstract_state_node_ptr = std::shared_ptr< abstract_state_node >;
+
+struct state_access_set;
+class parallel_executor;
+
 using receipt                 = std::variant< std::monostate, protocol::block_receipt, protocol::transaction_receipt >;
 
 struct stack_frame
@@ -71,12 +81,68 @@ struct thunk_cache_bundle
    bool     is_override;
 };
 
+using system_call_cache_entry = std::variant< system_call_cache_bundle, thunk_cache_bundle >;
+
+/**
+ * Compute bandwidth registry entries charged by thunks in addition to their base cost.
+ */
+enum class compute_cost : std::size_t
+{
+   deserialize_message_per_byte,
+   object_serialization_per_byte,
+   event_per_impacted,
+   deserialize_multihash_base,
+   deserialize_multihash_per_byte,
+   sha1_base,
+   sha1_per_byte,
+   sha2_256_base,
+   sha2_256_per_byte,
+   sha2_512_base,
+   sha2_512_per_byte,
+   keccak_256_base,
+   keccak_256_per_byte,
+   ripemd_160_base,
+   ripemd_160_per_byte,
+   num_costs
+};
+
+const std::string& compute_cost_name( compute_cost c );
+
+/**
+ * The compute bandwidth registry compiled into tables indexed by thunk id and by compute_cost.
+ * Entries missing from the registry are left empty.
+ */
+struct compute_cost_table
+{
+   std::array< std::optional< uint64_t >, system_call_id_ARRAYSIZE >                                   thunks;
+   std::array< std::optional< uint64_t >, static_cast< std::size_t >( compute_cost::num_costs ) > named;
+};
+
+/**
+ * Objects derived from the metadata and system call dispatch state of a single state node.
+ *
+ * Entries are built lazily and never modified once built, so a cache may be shared by
+ * any number of execution contexts reading the same parent state, including concurrently.
+ */
 struct execution_context_cache
 {
-   std::optional< std::map< std::string, uint64_t > > compute_bandwidth;
+   std::mutex                                    build_mutex;
+
+   std::atomic< bool >                           compute_bandwidth_ready = false;
+   std::map< std::string, uint64_t >             compute_bandwidth;
+   compute_cost_table                            compute_costs;
+
+   std::atomic< bool >                           descriptor_pool_ready = false;
    std::optional< google::protobuf::DescriptorPool > descriptor_pool;
-   std::map< uint32_t, std::variant< system_call_cache_bundle, thunk_cache_bundle > > system_call_table;
-   std::optional< crypto::multicodec > block_hash_code;
+
+   std::atomic< bool >                           block_hash_code_ready = false;
+   crypto::multicodec                            block_hash_code;
+
+   // Entries are owned by system_call_entries. Ids of known system calls are also published in the
+   // flat, id-indexed system_call_table so that resolving them is a single lock-free load.
+   std::shared_mutex                             system_call_mutex;
+   std::map< uint32_t, system_call_cache_entry > system_call_entries;
+   std::array< std::atomic< const system_call_cache_entry* >, system_call_id_ARRAYSIZE > system_call_table {};
 };
 
 class execution_context
@@ -98,6 +164,11 @@ class execution_context
       const protocol::block* get_block() const;
       void clear_block();
 
+      // Serializations of the block being applied, computed once per block
+      void set_serialized_block( const chain::serialized_block* );
+      const chain::serialized_block* get_serialized_block() const;
+      const chain::serialized_transaction* get_serialized_transaction( const protocol::transaction& ) const;
+
       void set_transaction( const protocol::transaction& );
       const protocol::transaction* get_transaction() const;
       void clear_transaction();
@@ -106,12 +177,28 @@ class execution_context
       const protocol::operation* get_operation() const;
       void clear_operation();
 
+      void set_signature_cache( std::shared_ptr< const chain::signature_cache > );
+      std::shared_ptr< const chain::signature_cache > signature_cache() const;
+
+      // While set, keys recovered by the recover_public_key thunk are recorded in the cache
+      void set_verified_signatures( verified_signature_cache* );
+      verified_signature_cache* verified_signatures() const;
+
+      // While set, objects accessed through the state system calls are recorded in the set
+      void set_state_access( std::shared_ptr< state_access_set > );
+      state_access_set* state_access() const;
+
+      void set_parallel_executor( std::shared_ptr< chain::parallel_executor > );
+      chain::parallel_executor* parallel_executor() const;
+
       void set_contract_call_args( const std::string& args );
       const std::string& get_contract_call_args() const;
 
       uint32_t get_contract_entry_point() const;
 
       uint64_t get_compute_bandwidth( const std::string& thunk_name );
+      uint64_t get_compute_bandwidth( compute_cost c );
+      uint64_t get_thunk_compute_bandwidth( uint32_t thunk_id );
 
       void push_frame( stack_frame&& frame );
       stack_frame pop_frame();
@@ -138,11 +225,22 @@ class execution_context
       chain::receipt& receipt();
 
       void reset_cache();
+      void set_cache( std::shared_ptr< execution_context_cache > );
+      std::shared_ptr< execution_context_cache > cache() const;
+
+      // Records that this context wrote an object the cache is derived from
+      void mark_cache_stale();
+      bool cache_stale() const;
 
       const google::protobuf::DescriptorPool& descriptor_pool();
 
+      // Resolves a system call id to its dispatch target, either a contract override or a thunk
+      const system_call_cache_entry& resolve_system_call( uint32_t id );
+
       const execution_result& system_call( uint32_t id, const std::string& args );
+      const execution_result& system_call( const system_call_cache_bundle& target, const std::string& args );
       uint32_t thunk_translation( uint32_t id );
+      uint32_t thunk_translation( uint32_t id, const thunk_cache_bundle& target );
       bool system_call_exists( uint32_t id );
       const crypto::multicodec& block_hash_code();
 
@@ -153,8 +251,9 @@ class execution_context
 
    private:
       void build_compute_registry_cache();
+      const compute_cost_table& compute_costs();
       void build_descriptor_pool();
-      void cache_system_call( uint32_t );
+      const system_call_cache_entry& cache_system_call( uint32_t );
       void build_block_hash_code_cache();
 
       std::shared_ptr< vm_manager::vm_backend > _vm_backend;
@@ -164,16 +263,23 @@ class execution_context
       abstract_state_node_ptr                   _parent_state_node;
 
       const protocol::block*                    _block = nullptr;
+      const chain::serialized_block*            _serialized_block = nullptr;
       const protocol::transaction*              _trx = nullptr;
       const protocol::operation*                _op = nullptr;
 
+      std::shared_ptr< const chain::signature_cache > _signature_cache;
+      verified_signature_cache*                 _verified_signatures = nullptr;
+      std::shared_ptr< state_access_set >       _state_access;
+      std::shared_ptr< chain::parallel_executor > _parallel_executor;
+
       chain::resource_meter                     _resource_meter;
       chain::chronicler                         _chronicler;
 
       chain::intent                             _intent;
       chain::receipt                            _receipt;
 
-      execution_context_cache                   _cache;
+      std::shared_ptr< execution_context_cache > _cache;
+      bool                                      _cache_stale = false;
       execution_result                          _result;
 };
 
@@ -20,6 +20,10 @@ class host_api final : public vm_manager::abstract_host_api
       virtual int32_t invoke_system_call( uint32_t sid, char* ret_ptr, uint32_t ret_len, const char* arg_ptr, uint32_t arg_len, uint32_t* bytes_written  ) override;
       virtual int64_t get_meter_ticks() const override;
       virtual void use_meter_ticks( uint64_t meter_ticks ) override;
+      virtual bool exited() const override;
+
+   private:
+      bool _exited = false;
 };
 
 } // koinos::chain
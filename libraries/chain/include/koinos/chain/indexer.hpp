@@ -2,31 +2,108 @@
 
 #include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <future>
+#include <mutex>
 #include <optional>
+#include <thread>
 
 #include <boost/asio.hpp>
 #include <boost/asio/signal_set.hpp>
+#include <boost/asio/thread_pool.hpp>
+#include <boost/thread/sync_bounded_queue.hpp>
 #include <boost/thread/sync_queue.hpp>
 
 #include <koinos/chain/controller.hpp>
 #include <koinos/chain/exceptions.hpp>
+#include <koinos/chain/prepared_block.hpp>
 #include <koinos/mq/client.hpp>
+#include <koinos/rpc/block_store/block_store_rpc.pb.h>
 
 namespace koinos::chain {
 
+/**
+ * Chooses how many blocks the indexer requests at a time.
+ *
+ * The batch size grows by at most 2x per request. It is limited by the blocks needed to cover
+ * a round trip at the measured apply rate, by the request timeout and by the queue memory
+ * ceiling shared by every in flight request.
+ */
+class batch_sizer final
+{
+public:
+   static constexpr uint64_t initial_batch_size = 50;
+   static constexpr uint64_t min_batch_size     = 10;
+   static constexpr uint64_t max_batch_size     = 1000;
+
+   batch_sizer( uint32_t max_requests, uint64_t max_queued_bytes, std::chrono::steady_clock::duration request_timeout );
+
+   uint64_t next_batch_size();
+
+   // Records a response to a request for num_blocks blocks and the total number of blocks applied so far.
+   // Latency is only given for responses that were waited on.
+   void update(
+      uint64_t num_blocks,
+      uint64_t response_bytes,
+      std::optional< std::chrono::steady_clock::duration > latency,
+      uint64_t blocks_applied,
+      std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now()
+   );
+
+   double average_block_bytes();
+
+private:
+   const uint32_t _max_requests;
+   const uint64_t _max_queued_bytes;
+   const double   _request_timeout;
+
+   std::mutex _mutex;
+   uint64_t _last_batch_size = 0;
+   double _avg_block_bytes = 0;
+   double _avg_latency = 0;
+   double _avg_apply_rate = 0;
+   uint64_t _last_applied_sample = 0;
+   std::optional< std::chrono::steady_clock::time_point > _last_apply_sample_time;
+};
+
 class indexer final
 {
 public:
-   indexer( boost::asio::io_context& ioc, controller& c, std::shared_ptr< mq::client > mc );
+   indexer(
+      boost::asio::io_context& ioc,
+      controller& c,
+      std::shared_ptr< mq::client > mc,
+      uint32_t max_requests = 4,
+      uint64_t max_queued_bytes = 512'000'000
+   );
+   ~indexer();
 
    std::future< bool > index();
 
 private:
+   struct block_request
+   {
+      uint64_t                              num_blocks;
+      uint64_t                              reserved_bytes;
+      std::chrono::steady_clock::time_point sent;
+      std::shared_future< std::string >     response;
+   };
+
+   struct queued_block
+   {
+      std::shared_future< std::shared_ptr< const prepared_block > > block;
+      uint64_t                                                      bytes;
+   };
+
    void prepare_index();
-   void send_requests( uint64_t last_height, uint64_t batch_size );
-   void process_requests( uint64_t last_height, uint64_t batch_size );
+   void send_requests( uint64_t last_height );
+   void process_requests();
    void process_block();
+   void prepare_blocks( rpc::block_store::get_blocks_by_height_response&& resp );
+   void log_stats();
+
+   uint64_t reserve_queue_memory( uint64_t num_blocks );
+   void release_queue_memory( uint64_t bytes );
 
    void handle_error( const std::string& msg );
 
@@ -36,17 +113,36 @@ private:
    boost::asio::signal_set _signals;
    std::atomic_bool _stopped = false;
 
-   boost::concurrent::sync_queue< std::shared_future< std::string > > _request_queue;
-   std::atomic< bool > _requests_complete = false;
-   std::atomic< bool > _request_processing_complete = false;
+   const uint32_t _max_requests;
+   const uint64_t _max_queued_bytes;
+
+   boost::concurrent::sync_bounded_queue< block_request > _request_queue;
+   boost::concurrent::sync_queue< queued_block > _block_queue;
 
-   boost::concurrent::sync_queue< protocol::block > _block_queue;
+   std::mutex _queue_memory_mutex;
+   std::condition_variable _queue_memory_cv;
+   uint64_t _queued_bytes = 0;
+
+   batch_sizer _batch_sizer;
+
+   std::atomic< uint64_t > _blocks_fetched  = 0;
+   std::atomic< uint64_t > _blocks_prepared = 0;
+   std::atomic< uint64_t > _blocks_applied  = 0;
 
    block_topology _target_head;
    rpc::chain::get_head_info_response _start_head_info;
    const std::chrono::time_point< std::chrono::system_clock > _start_time = std::chrono::system_clock::now();
 
    std::optional< std::promise< bool > > _complete = std::promise< bool >();
+
+   // Every stage blocks on its queues, so each runs on its own thread rather than a shared executor
+   std::thread _index_thread;
+   std::thread _send_thread;
+   std::thread _request_thread;
+   std::thread _apply_thread;
+
+   // Declared last so that it is joined before the members its jobs reference are destroyed
+   boost::asio::thread_pool _prepare_pool;
 };
 
 } // koinos::chain
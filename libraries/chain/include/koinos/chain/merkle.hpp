@@ -0,0 +1,17 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+namespace koinos::chain::merkle {
+
+/**
+ * Reduces SHA-256 leaf digests stored back to back in digests to their merkle root in place,
+ * one level at a time, and returns the root. digests must hold at least one digest.
+ *
+ * The tree matches crypto::merkle_tree over multihash leaves. Siblings are hashed as the
+ * concatenation of their digests and an unpaired digest is carried up to the next level.
+ */
+std::string_view sha256_merkle_root( std::string& digests );
+
+} // koinos::chain::merkle
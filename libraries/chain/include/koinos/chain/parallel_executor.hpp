@@ -0,0 +1,74 @@
+#pragma once
+
+#include <koinos/chain/execution_context.hpp>
+
+#include <koinos/chain/chain.pb.h>
+#include <koinos/protocol/protocol.pb.h>
+
+#include <boost/asio/thread_pool.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <set>
+#include <string>
+#include <utility>
+
+namespace koinos::chain {
+
+/**
+ * The objects read and written through the state system calls while the set is attached to
+ * an execution context.
+ *
+ * get_next_object and get_prev_object read a range of keys, so they are recorded by space
+ * and conflict with a write to any key in that space.
+ */
+struct state_access_set
+{
+   using key_type = std::pair< std::string, std::string >;
+
+   std::set< key_type >    reads;
+   std::set< key_type >    writes;
+   std::set< std::string > range_reads;
+
+   void record_read( const object_space& space, const std::string& key );
+   void record_write( const object_space& space, const std::string& key );
+   void record_range_read( const object_space& space );
+
+   // True if anything accessed here was written in other
+   bool conflicts_with( const state_access_set& other ) const;
+   void merge_writes( const state_access_set& other );
+};
+
+struct parallel_executor_stats
+{
+   uint64_t speculated = 0;
+   uint64_t reexecuted = 0;
+};
+
+/**
+ * Applies the transactions of a block in parallel.
+ *
+ * Every transaction is first executed speculatively on the worker pool against the block state
+ * as it was before any transaction, recording the objects it accesses. The results are then
+ * committed in block order. A transaction is executed again, in order, if it accessed an object
+ * an earlier transaction in the block wrote, if the block could not have covered its resource
+ * usage at that point, or if it failed. The state, receipts and resource usage of the block are
+ * therefore identical to applying its transactions one at a time.
+ */
+class parallel_executor final
+{
+   public:
+      parallel_executor( boost::asio::thread_pool& pool );
+
+      void apply_transactions( execution_context& ctx, const protocol::block& block );
+
+      parallel_executor_stats stats() const;
+
+   private:
+      boost::asio::thread_pool& _pool;
+
+      std::atomic< uint64_t >   _speculated = 0;
+      std::atomic< uint64_t >   _reexecuted = 0;
+};
+
+} // koinos::chain
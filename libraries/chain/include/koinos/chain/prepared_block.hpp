@@ -0,0 +1,61 @@
+#pragma once
+
+#include <koinos/chain/signature_cache.hpp>
+#include <koinos/protocol/protocol.pb.h>
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace koinos::chain {
+
+/**
+ * The canonical serializations of a transaction that block application hashes and meters.
+ */
+struct serialized_transaction
+{
+   std::string                header;
+   std::string                signatures;
+   std::vector< std::string > operations;
+   std::size_t                size = 0;
+};
+
+/**
+ * The canonical serializations of a block and its transactions, each computed once.
+ *
+ * Transactions are found by address, so a serialized block only describes the block
+ * instance it was created from.
+ */
+struct serialized_block
+{
+   const protocol::block*                source = nullptr;
+   std::string                           header;
+   std::string                           block;
+   std::size_t                           transactions_size = 0;
+   std::vector< serialized_transaction > transactions;
+
+   std::unordered_map< const protocol::transaction*, std::size_t > index;
+
+   bool describes( const protocol::block& b ) const;
+   const serialized_transaction* find( const protocol::transaction& trx ) const;
+};
+
+serialized_transaction serialize_transaction( const protocol::transaction& trx );
+serialized_block serialize_block( const protocol::block& block );
+
+/**
+ * A block that has passed stateless validation and had its signatures recovered.
+ *
+ * Preparation does not depend on chain state, so it can run ahead of block
+ * application on any thread. Instances are produced by controller::prepare_block.
+ */
+struct prepared_block
+{
+   protocol::block                          block;
+   std::shared_ptr< const signature_cache > signatures;
+   serialized_block                         serialized;
+};
+
+} // koinos::chain
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <koinos/rpc/chain/chain_rpc.pb.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace koinos::chain {
+
+struct read_contract_cache_stats
+{
+   uint64_t hits    = 0;
+   uint64_t misses  = 0;
+   uint64_t shared  = 0;
+   uint64_t entries = 0;
+};
+
+/**
+ * A bounded LRU cache of read_contract responses for the current head block.
+ *
+ * A read is fully determined by the head state and the request, so a response is cached under
+ * the head block id, contract id, entry point and a digest of the arguments. Only responses for
+ * the current head are cached, and every entry is dropped when the head changes.
+ *
+ * Concurrent misses for the same read wait for the first of them to execute instead of executing
+ * the contract again. They receive its response, or rethrow its exception. Failed reads are not cached.
+ */
+class read_contract_cache final
+{
+   public:
+      using execute_function = std::function< rpc::chain::read_contract_response() >;
+
+      read_contract_cache( std::size_t max_entries );
+
+      void set_head( const std::string& head_id );
+
+      rpc::chain::read_contract_response get(
+         const std::string& head_id,
+         const rpc::chain::read_contract_request& request,
+         const execute_function& execute
+      );
+
+      read_contract_cache_stats stats() const;
+
+   private:
+      struct entry
+      {
+         std::string                        key;
+         rpc::chain::read_contract_response response;
+      };
+
+      using lru_list_type = std::list< entry >;
+
+      std::size_t                                                                        _max_entries;
+
+      mutable std::mutex                                                                 _mutex;
+      std::string                                                                        _head_id;
+      lru_list_type                                                                      _lru_list;
+      std::unordered_map< std::string, typename lru_list_type::iterator >                _entries;
+      std::unordered_map< std::string, std::shared_future< rpc::chain::read_contract_response > > _in_flight;
+
+      uint64_t                                                                           _hits   = 0;
+      uint64_t                                                                           _misses = 0;
+      uint64_t                                                                           _shared = 0;
+};
+
+} // koinos::chain
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <boost/asio/thread_pool.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace koinos::chain {
+
+enum class request_class : std::size_t
+{
+   block,
+   transaction,
+   read
+};
+
+constexpr std::size_t num_request_classes = 3;
+
+const std::string& to_string( request_class c );
+
+struct request_class_config
+{
+   // The number of requests of the class that may execute concurrently
+   std::size_t threads         = 1;
+   // The number of requests of the class that may wait to execute, 0 for no limit
+   std::size_t max_queue_depth = 0;
+};
+
+struct request_class_stats
+{
+   uint64_t                  admitted   = 0;
+   uint64_t                  rejected   = 0;
+   uint64_t                  completed  = 0;
+   uint64_t                  queued     = 0;
+   uint64_t                  executing  = 0;
+   std::chrono::microseconds total_wait = std::chrono::microseconds::zero();
+   std::chrono::microseconds max_wait   = std::chrono::microseconds::zero();
+};
+
+/**
+ * Executes RPC requests on a separate thread pool per request class, so a backlog of one class
+ * never delays requests of another. Blocks are never queued behind reads or transactions.
+ *
+ * This only isolates queueing. Reads pin the head snapshot rather than locking the database, and
+ * the controller defers a block's commit while pins are held. A commit that has been deferred too
+ * often still waits for the reads already executing, but never for queued ones.
+ *
+ * A request that would exceed the queue depth of its class is rejected with
+ * request_rejected_exception without being executed.
+ */
+class request_scheduler final
+{
+   public:
+      request_scheduler( const request_class_config& block, const request_class_config& transaction, const request_class_config& read );
+      ~request_scheduler();
+
+      // Executes the function on the pool of the class and waits for it, rethrowing its exception
+      void execute( request_class c, const std::function< void() >& function );
+
+      request_class_stats stats( request_class c ) const;
+
+      // The most requests of the class that are admitted at once
+      std::size_t capacity( request_class c ) const;
+
+      void stop();
+
+   private:
+      struct executor
+      {
+         request_class_config                         config;
+         std::unique_ptr< boost::asio::thread_pool >  pool;
+         request_class_stats                          stats;
+      };
+
+      executor& get_executor( request_class c );
+      const executor& get_executor( request_class c ) const;
+
+      mutable std::mutex                             _mutex;
+      std::array< executor, num_request_classes >    _executors;
+      bool                                           _stopped = false;
+};
+
+} // koinos::chain
@@ -45,6 +45,17 @@ public:
    uint64_t compute_bandwidth_remaining() const;
    uint64_t system_compute_bandwidth_used() const;
 
+   // Starts recording the usage a later merge of this meter applies
+   void mark();
+
+   /**
+    * Applies the usage recorded by a meter since it was copied from start and marked. Returns false
+    * and leaves this meter unchanged if this meter could not have covered that usage at its peak, or
+    * if the compute bandwidth it reported would have been limited by this meter instead, in which
+    * case applying the same calls to this meter would not have had the same result.
+    */
+   bool merge( const resource_meter& start, const resource_meter& other );
+
 private:
 
    uint64_t _disk_storage_remaining        = 0;
@@ -53,6 +64,14 @@ private:
    int64_t _system_network_bandwidth_used  = 0;
    uint64_t _compute_bandwidth_remaining   = 0;
    int64_t _system_compute_bandwidth_used  = 0;
+
+   // The lowest remaining amount of each resource, used to merge meters
+   uint64_t _disk_storage_low              = 0;
+   uint64_t _network_bandwidth_low         = 0;
+   uint64_t _compute_bandwidth_low         = 0;
+
+   // How far the compute bandwidth remaining stayed above the amount reported while limited by a session
+   mutable uint64_t _compute_bandwidth_headroom = 0;
    resource_limit_data _resource_limit_data;
    std::weak_ptr< abstract_rc_session > _session;
 };
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace koinos::chain::sha256 {
+
+constexpr std::size_t digest_size = 32;
+
+// The number of messages hashed at a time
+constexpr std::size_t lanes = 8;
+
+/**
+ * Hashes count 64 byte messages stored back to back in in, writing their digests back to back
+ * to out. Messages are hashed several at a time in lanes, so that the compiler can vectorize the
+ * rounds across messages, and any remainder one at a time.
+ *
+ * out may alias in, every message is read before the digests of its batch are written.
+ */
+void hash_pairs( const char* in, char* out, std::size_t count );
+
+/**
+ * Hashes every message, writing their digests back to back to out in the same order.
+ *
+ * Messages are grouped by length before they are assigned to lanes, so lanes rarely idle
+ * while another lane finishes a longer message.
+ */
+void hash_many( const std::vector< const std::string* >& messages, char* out );
+
+} // koinos::chain::sha256
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <boost/asio/thread_pool.hpp>
+
+#include <koinos/crypto/elliptic.hpp>
+#include <koinos/protocol/protocol.pb.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+namespace koinos::chain {
+
+/**
+ * A read-only set of public keys recovered ahead of execution, keyed by (signature, digest).
+ *
+ * The cache only replaces the secp256k1 recovery inside the recover_public_key thunk.
+ * Signature validation and compute charges are applied exactly as if the key had been
+ * recovered inline, so a cache hit is indistinguishable from a miss to consensus.
+ */
+class signature_cache final
+{
+   public:
+      using key_type = std::pair< std::string, std::string >;
+
+      std::optional< crypto::public_key > get( const std::string& signature, const std::string& digest ) const;
+      void put( const std::string& signature, const std::string& digest, const crypto::public_key& key );
+
+      std::size_t size() const;
+
+   private:
+      std::map< key_type, crypto::public_key > _keys;
+};
+
+constexpr std::size_t default_verified_signature_cache_size = 1 << 16;
+
+struct verified_signature_cache_stats
+{
+   uint64_t hits    = 0;
+   uint64_t misses  = 0;
+   uint64_t entries = 0;
+};
+
+/**
+ * A concurrent LRU cache of public keys recovered by earlier requests, bounded by its number of entries.
+ *
+ * The recover_public_key thunk records the keys it recovers while a submitted transaction is
+ * applied, so recovering the block the transaction later arrives in only has to look them up.
+ * Only keys recovered inside the metered thunk are recorded. A key is fully determined by its signature and digest, so an entry is valid
+ * regardless of which request recovered it or whether that request succeeded.
+ */
+class verified_signature_cache final
+{
+   private:
+      static constexpr std::size_t num_shards = 16;
+
+      struct entry
+      {
+         std::string        id;
+         crypto::public_key key;
+      };
+
+      using lru_list_type = std::list< entry >;
+
+      struct shard
+      {
+         std::mutex                                                               mutex;
+         lru_list_type                                                            lru_list;
+         std::unordered_map< std::string_view, typename lru_list_type::iterator > key_map;
+      };
+
+      std::array< shard, num_shards > _shards;
+      const std::size_t               _shard_capacity;
+
+      std::atomic< uint64_t >         _hits   = 0;
+      std::atomic< uint64_t >         _misses = 0;
+
+      shard& get_shard( const std::string& id );
+
+   public:
+      verified_signature_cache( std::size_t capacity = default_verified_signature_cache_size );
+
+      std::optional< crypto::public_key > get( const std::string& signature, const std::string& digest );
+      void put( const std::string& signature, const std::string& digest, const crypto::public_key& key );
+
+      verified_signature_cache_stats stats();
+};
+
+/**
+ * Recovers the block signature and every transaction signature in a block.
+ *
+ * Signatures that cannot be recovered are left out of the cache so that the thunk
+ * reports the failure when the signature is consumed during block application.
+ * Keys found in verified are not recovered again. With a pool, the signatures are split
+ * into at most num_workers chunks, where num_workers is the number of threads in the pool.
+ */
+std::shared_ptr< const signature_cache > recover_block_signatures( const protocol::block& block, verified_signature_cache* verified = nullptr );
+std::shared_ptr< const signature_cache > recover_block_signatures( const protocol::block& block, boost::asio::thread_pool& pool, std::size_t num_workers, verified_signature_cache* verified = nullptr );
+
+} // koinos::chain
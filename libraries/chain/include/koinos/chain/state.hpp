@@ -56,6 +56,9 @@ constexpr uint32_t max_object_size = 1024 * 1024; // 1 MB
 
 void assert_permissions( execution_context& context, const object_space& space );
 
+// Returns true if the object is read when building an execution_context_cache
+bool is_cache_dependency( const object_space& space, const std::string& object_key );
+
 } // state
 
 } // koinos::chain
@@ -112,6 +112,14 @@ THUNK_DECLARE( verify_merkle_root_result, verify_merkle_root, const std::string&
 THUNK_DECLARE( verify_signature_result, verify_signature, dsa type, const std::string& public_key, const std::string& signature, const std::string& digest, bool compressed );
 THUNK_DECLARE( verify_vrf_proof_result, verify_vrf_proof, dsa type, const std::string& public_key, const std::string& proof, const std::string& hash, const std::string& message );
 
+/**
+ * Hashes every input, returning the same multihashes as calling system_call::hash on each input
+ * in order. Compute is charged per input, in the same order and amount as those calls.
+ *
+ * When hash is overridden each input is hashed through the system call instead.
+ */
+std::vector< std::string > hash_batch( execution_context& context, uint64_t code, const std::vector< const std::string* >& inputs );
+
 // Contract Management
 
 THUNK_DECLARE( call_result, call, const std::string& contract_id, uint32_t entry_point, const std::string& args );
@@ -8,280 +8,129 @@
 #include <google/protobuf/descriptor.h>
 
 #include <any>
+#include <array>
 #include <cstdint>
 #include <functional>
-#include <map>
+#include <string>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace koinos::chain {
 
 namespace detail
 {
-   template< typename T, typename Lambda >
-   std::enable_if_t< std::is_same_v< decltype( std::declval< Lambda >()( std::declval< int >() ) ), T >, void >
-   iterate_repeated_field( const google::protobuf::Message& msg, const google::protobuf::FieldDescriptor* fd, std::vector< T >& v, Lambda&& l )
-   {
-      auto ref = msg.GetReflection();
-      for( int i = 0; i < ref->FieldSize( msg, fd ); i++ )
-      {
-         v.emplace_back( l( i ) );
-      }
-   }
-
-   template< typename T, typename Lambda >
-   std::enable_if_t< !std::is_same_v< decltype( std::declval< Lambda >()( std::declval< int >() ) ), T >, void >
-   iterate_repeated_field( const google::protobuf::Message& msg, const google::protobuf::FieldDescriptor* fd, std::vector< T >& v, Lambda&& l ) {}
-
    template< typename T >
-   std::enable_if_t< std::is_base_of_v< google::protobuf::Message, T >, void >
-   copy_from( const google::protobuf::Message& m, T& t )
-   {
-      t.CopyFrom( m );
-   }
+   struct is_vector : std::false_type {};
 
    template< typename T >
-   std::enable_if_t< !std::is_base_of_v< google::protobuf::Message, T >, void >
-   copy_from( const google::protobuf::Message& m, T& t ) {}
+   struct is_vector< std::vector< T > > : std::true_type {};
 
-   inline std::any get_type_from_field_impl( const google::protobuf::Message& msg, const google::protobuf::FieldDescriptor* fd )
-   {
-      auto ref = msg.GetReflection();
-      std::any field;
-
-      switch( fd->cpp_type() )
-      {
-         case google::protobuf::FieldDescriptor::CppType::CPPTYPE_INT64:
-            field = ref->GetInt64( msg, fd );
-            break;
-         case google::protobuf::FieldDescriptor::CppType::CPPTYPE_UINT64:
-            field = ref->GetUInt64( msg, fd );
-            break;
-         case google::protobuf::FieldDescriptor::CppType::CPPTYPE_INT32:
-            field = ref->GetInt32( msg, fd );
-            break;
-         case google::protobuf::FieldDescriptor::CppType::CPPTYPE_UINT32:
-            field = ref->GetUInt32( msg, fd );
-            break;
-         case google::protobuf::FieldDescriptor::CppType::CPPTYPE_BOOL:
-            field = ref->GetBool( msg, fd );
-            break;
-         case google::protobuf::FieldDescriptor::CppType::CPPTYPE_STRING:
-            field = ref->GetString( msg, fd );
-            break;
-         case google::protobuf::FieldDescriptor::CppType::CPPTYPE_MESSAGE:
-            field = &ref->GetMessage( msg, fd );
-            break;
-         case google::protobuf::FieldDescriptor::CppType::CPPTYPE_ENUM:
-            field = ref->GetEnumValue( msg, fd );
-            break;
-         case google::protobuf::FieldDescriptor::CppType::CPPTYPE_FLOAT:
-            field = ref->GetFloat( msg, fd );
-            break;
-         case google::protobuf::FieldDescriptor::CppType::CPPTYPE_DOUBLE:
-            field = ref->GetDouble( msg, fd );
-            break;
-         default:
-            assert( "Type not handled for thunk args." );
-      }
-
-      return field;
-   }
+   // Strings and messages are bound by reference to the parsed argument message,
+   // everything else is bound by value.
+   template< typename T >
+   using bound_arg_t = std::conditional_t<
+      std::is_same_v< std::decay_t< T >, std::string > || std::is_base_of_v< google::protobuf::Message, std::decay_t< T > >,
+      const std::decay_t< T >&,
+      std::decay_t< T >
+   >;
 
-   // Parses through a repeated field and puts values in a vector.
    template< typename T >
-   std::any get_type_from_repeated_field( const google::protobuf::Message& msg, const google::protobuf::FieldDescriptor* fd )
+   bound_arg_t< T > get_field( const google::protobuf::Message& msg, const google::protobuf::FieldDescriptor* fd, std::string& scratch )
    {
+      using type = std::decay_t< T >;
       auto ref = msg.GetReflection();
-      std::any field;
 
-      switch( fd->cpp_type() )
+      if constexpr ( std::is_same_v< type, std::string > )
+         return ref->GetStringReference( msg, fd, &scratch );
+      else if constexpr ( std::is_base_of_v< google::protobuf::Message, type > )
+         return static_cast< const type& >( ref->GetMessage( msg, fd ) );
+      else if constexpr ( is_vector< type >::value )
       {
-         case google::protobuf::FieldDescriptor::CppType::CPPTYPE_INT64:
-         {
-            std::vector< int64_t > v;
-            iterate_repeated_field( msg, fd, v, [&]( int i )
-            {
-               return ref->GetRepeatedInt64( msg, fd, i );
-            } );
-            field = std::move( v );
-            break;
-         }
-         case google::protobuf::FieldDescriptor::CppType::CPPTYPE_UINT64:
-         {
-            std::vector< uint64_t > v;
-            iterate_repeated_field( msg, fd, v, [&]( int i )
-            {
-               return ref->GetRepeatedUInt64( msg, fd, i );
-            } );
-            field = std::move( v );
-            break;
-         }
-         case google::protobuf::FieldDescriptor::CppType::CPPTYPE_INT32:
-         {
-            std::vector< int32_t > v;
-            iterate_repeated_field( msg, fd, v, [&]( int i )
-            {
-               return ref->GetRepeatedInt32( msg, fd, i );
-            } );
-            field = std::move( v );
-            break;
-         }
-         case google::protobuf::FieldDescriptor::CppType::CPPTYPE_UINT32:
-         {
-            std::vector< uint32_t > v;
-            iterate_repeated_field( msg, fd, v, [&]( int i )
-            {
-               return ref->GetRepeatedUInt32( msg, fd, i );
-            } );
-            field = std::move( v );
-            break;
-         }
-         case google::protobuf::FieldDescriptor::CppType::CPPTYPE_BOOL:
-         {
-            std::vector< bool > v;
-            iterate_repeated_field( msg, fd, v, [&]( int i )
-            {
-               return ref->GetRepeatedBool( msg, fd, i );
-            } );
-            field = std::move( v );
-            break;
-         }
-         case google::protobuf::FieldDescriptor::CppType::CPPTYPE_STRING:
-         {
-            std::vector< std::string > v;
-            iterate_repeated_field( msg, fd, v, [&]( int i )
-            {
-               return ref->GetRepeatedString( msg, fd, i );
-            } );
-            field = std::move( v );
-            break;
-         }
-         case google::protobuf::FieldDescriptor::CppType::CPPTYPE_MESSAGE:
-         {
-            std::vector< T > v;
-            iterate_repeated_field( msg, fd, v, [&]( int i )
-            {
-               T t;
-               copy_from( ref->GetRepeatedMessage( msg, fd, i ), t );
-               return t;
-            } );
-            field = std::move( v );
-            break;
-         }
-         case google::protobuf::FieldDescriptor::CppType::CPPTYPE_ENUM:
-         {
-            std::vector< int > v;
-            iterate_repeated_field( msg, fd, v, [&]( int i )
-            {
-               return ref->GetRepeatedEnum( msg, fd, i );
-            } );
-            field = std::move( v );
-            break;
-         }
-         default:
-            assert( "Type not handled for thunk args." );
+         auto field = ref->GetRepeatedFieldRef< typename type::value_type >( msg, fd );
+         return type( field.begin(), field.end() );
       }
-
-      return field;
-   }
-
-   // Overload to capture when field is repeated (vector)
-   template< typename T >
-   void get_type_from_field( const google::protobuf::Message& msg, const google::protobuf::FieldDescriptor* fd, std::vector< T >& v )
-   {
-      v = std::any_cast< std::vector< T > >( get_type_from_repeated_field< T >( msg, fd ) );
-   }
-
-   // Overload to capture when field is a Message
-   template< typename T >
-   std::enable_if_t< std::is_base_of_v< google::protobuf::Message, T >, void >
-   get_type_from_field( const google::protobuf::Message& msg, const google::protobuf::FieldDescriptor* fd, T& t )
-   {
-      auto ptr = std::any_cast< const google::protobuf::Message* >( get_type_from_field_impl( msg, fd ) );
-      t.CopyFrom( *ptr );
-   }
-
-   // Overload to capture when field is an Enum
-   template< typename T >
-   std::enable_if_t< !std::is_base_of_v< google::protobuf::Message, T > && std::is_enum_v< T >, void >
-   get_type_from_field( const google::protobuf::Message& msg, const google::protobuf::FieldDescriptor* fd, T& t )
-   {
-      t = T( std::any_cast< std::underlying_type_t< T > >( get_type_from_field_impl( msg, fd ) ) );
-   }
-
-   // Overload to capture when field is neither
-   template< typename T >
-   std::enable_if_t< !std::is_base_of_v< google::protobuf::Message, T > && !std::is_enum_v< T >, void >
-   get_type_from_field( const google::protobuf::Message& msg, const google::protobuf::FieldDescriptor* fd, T& t )
-   {
-      t = std::any_cast< T >( get_type_from_field_impl( msg, fd ) );
+      else if constexpr ( std::is_enum_v< type > )
+         return type( ref->GetEnumValue( msg, fd ) );
+      else if constexpr ( std::is_same_v< type, bool > )
+         return ref->GetBool( msg, fd );
+      else if constexpr ( std::is_same_v< type, int32_t > )
+         return ref->GetInt32( msg, fd );
+      else if constexpr ( std::is_same_v< type, uint32_t > )
+         return ref->GetUInt32( msg, fd );
+      else if constexpr ( std::is_same_v< type, int64_t > )
+         return ref->GetInt64( msg, fd );
+      else if constexpr ( std::is_same_v< type, uint64_t > )
+         return ref->GetUInt64( msg, fd );
+      else if constexpr ( std::is_same_v< type, float > )
+         return ref->GetFloat( msg, fd );
+      else if constexpr ( std::is_same_v< type, double > )
+         return ref->GetDouble( msg, fd );
+      else
+         static_assert( !std::is_same_v< type, type >, "Type not handled for thunk args." );
    }
 
-   // Variadic recusrive template to convert fields of a message in to a tuple
-   // Arg type information is assumed to match the fields of the corresponding Message
-   // Each call strips off the next argument (T), parses it with get_type_from_field,
-   // adds it to the tuple and recusively calls with the remaining arguments (Ts).
-   // The base case is when there are no more fields remaining (Ts is empty).
-   template< typename T, typename... Ts >
-   std::tuple< T, Ts... > message_to_tuple_impl( const google::protobuf::Message& msg )
+   /*
+    * Arg type information is assumed to match the fields of the corresponding Message. The thunk's
+    * Nth argument is the Nth of the last sizeof...( ThunkArgs ) fields. Descriptors are resolved
+    * once, when the thunk is registered.
+    */
+   template< typename ArgStruct, typename... ThunkArgs >
+   std::array< const google::protobuf::FieldDescriptor*, sizeof...( ThunkArgs ) > arg_fields()
    {
-      // Get our type
-      constexpr std::size_t fields_remaining = sizeof...( Ts );
-      auto desc = msg.GetDescriptor();
-      auto fd = desc->FindFieldByNumber( desc->field_count() - fields_remaining );
-      T t;
-      get_type_from_field( msg, fd, t );
+      std::array< const google::protobuf::FieldDescriptor*, sizeof...( ThunkArgs ) > fields;
+      auto desc = ArgStruct::descriptor();
 
-      if constexpr ( fields_remaining > 0 )
-         return std::tuple_cat( std::tuple< T >( std::move( t ) ), message_to_tuple_impl< Ts... >( msg ) );
-      else
-         return std::tuple< T >( std::move( t ) );
-   }
+      for ( std::size_t i = 0; i < fields.size(); i++ )
+         fields[ i ] = desc->FindFieldByNumber( int( desc->field_count() - fields.size() + 1 + i ) );
 
-   template< typename... Ts >
-   std::tuple< std::decay_t< Ts >... > message_to_tuple( const google::protobuf::Message& msg )
-   {
-      return message_to_tuple_impl< std::decay_t< Ts >... >( msg );
+      return fields;
    }
 
-   template<>
-   inline std::tuple<> message_to_tuple<>( const google::protobuf::Message& )
+   template< typename ThunkReturn, typename... ThunkArgs, std::size_t... I >
+   ThunkReturn apply_thunk(
+      ThunkReturn (*thunk)(execution_context&, ThunkArgs...),
+      execution_context& ctx,
+      const google::protobuf::Message& arg,
+      const std::array< const google::protobuf::FieldDescriptor*, sizeof...( ThunkArgs ) >& fields,
+      std::index_sequence< I... > )
    {
-      return std::tuple<>();
+      [[maybe_unused]] std::array< std::string, sizeof...( ThunkArgs ) > scratch;
+      return thunk( ctx, get_field< ThunkArgs >( arg, fields[ I ], scratch[ I ] )... );
    }
 
    /*
-    * std::apply takes a function and a tuple and calls the function with the contents of the tuple
-    * as the arguments. The only "trick" here is converting a reflected object in to an equivalent
-    * tuple. That is handled as part of the reflection macro to generate the needed code. We cat a
-    * tuple containing just the apply context as the first argument and then call in to the thunk.
+    * Calls the thunk with arguments bound directly to the fields of the parsed argument message.
     *
     * Two versions exist of the function, one that serializes the return value and one that does not.
+    * The return value is serialized straight into the caller's buffer.
     */
    template< typename ArgStruct, typename RetStruct, typename ThunkReturn, typename... ThunkArgs >
    typename std::enable_if< std::is_same< ThunkReturn, void >::value, void >::type
-   call_thunk_impl( const std::function< ThunkReturn(execution_context&, ThunkArgs...) >& thunk, execution_context& ctx, char* ret_ptr, uint32_t ret_len, ArgStruct& arg, uint32_t* bytes_written  )
+   call_thunk_impl(
+      ThunkReturn (*thunk)(execution_context&, ThunkArgs...),
+      const std::array< const google::protobuf::FieldDescriptor*, sizeof...( ThunkArgs ) >& fields,
+      execution_context& ctx, char* ret_ptr, uint32_t ret_len, const ArgStruct& arg, uint32_t* bytes_written )
    {
-      auto thunk_args = std::tuple_cat( std::tuple< execution_context& >( ctx ), message_to_tuple< ThunkArgs... >( arg ) );
       *bytes_written = 0;
-
-      std::apply( thunk, thunk_args );
+      apply_thunk( thunk, ctx, arg, fields, std::index_sequence_for< ThunkArgs... >() );
    }
 
    template< typename ArgStruct, typename RetStruct, typename ThunkReturn, typename... ThunkArgs >
    typename std::enable_if< !std::is_same< ThunkReturn, void >::value, void >::type
-   call_thunk_impl( const std::function< ThunkReturn(execution_context&, ThunkArgs...) >& thunk, execution_context& ctx, char* ret_ptr, uint32_t ret_len, ArgStruct& arg, uint32_t* bytes_written )
+   call_thunk_impl(
+      ThunkReturn (*thunk)(execution_context&, ThunkArgs...),
+      const std::array< const google::protobuf::FieldDescriptor*, sizeof...( ThunkArgs ) >& fields,
+      execution_context& ctx, char* ret_ptr, uint32_t ret_len, const ArgStruct& arg, uint32_t* bytes_written )
    {
       static_assert( std::is_same< RetStruct, ThunkReturn >::value, "thunk return does not match defined return in koinos-proto" );
-      auto thunk_args = std::tuple_cat( std::tuple< execution_context& >( ctx ), message_to_tuple< ThunkArgs... >( arg ) );
-      ThunkReturn ret;
-
-      ret = std::apply( thunk, thunk_args );
+      ThunkReturn ret = apply_thunk( thunk, ctx, arg, fields, std::index_sequence_for< ThunkArgs... >() );
 
       std::size_t byte_size = ret.ByteSizeLong();
       KOINOS_ASSERT( byte_size <= ret_len, insufficient_return_buffer_exception, "return buffer is not large enough for the return value" );
 
-      ret.SerializeToArray( ret_ptr, uint32_t( byte_size ) );
+      // ByteSizeLong cached the sizes, so serialize without computing them again
+      ret.SerializeWithCachedSizesToArray( reinterpret_cast< uint8_t* >( ret_ptr ) );
       *bytes_written = uint32_t( byte_size );
    }
 
@@ -311,30 +160,32 @@ class thunk_dispatcher
       template< typename ThunkReturn, typename... ThunkArgs >
       auto call_thunk( uint32_t id, execution_context& ctx, ThunkArgs&... args ) const
       {
-         auto it = _pass_through_map.find( id );
-         KOINOS_ASSERT( it != _pass_through_map.end(), unknown_thunk_exception, "thunk ${id} not found", ("id", id ) );
-         return std::any_cast< std::function<ThunkReturn(execution_context&, ThunkArgs...)> >(it->second)( ctx, args... );
+         const auto* entry = get_entry( id );
+         KOINOS_ASSERT( entry, unknown_thunk_exception, "thunk ${id} not found", ("id", id ) );
+         return std::any_cast< const std::function<ThunkReturn(execution_context&, ThunkArgs...)>& >(entry->pass_through)( ctx, args... );
       }
 
       template< typename ArgStruct, typename RetStruct, typename ThunkReturn, typename... ThunkArgs >
       void register_thunk( uint32_t id, ThunkReturn (*thunk_ptr)(execution_context&, ThunkArgs...) )
       {
          std::function<ThunkReturn(execution_context&, ThunkArgs...)> thunk = thunk_ptr;
-         _dispatch_map.insert_or_assign( id, [thunk]( execution_context& ctx, char* ret_ptr, uint32_t ret_len, const char* arg_ptr, uint32_t arg_len, uint32_t* bytes_written )
+         auto fields = detail::arg_fields< ArgStruct, ThunkArgs... >();
+         auto& entry = get_or_create_entry( id );
+         entry.handler = [thunk_ptr, fields]( execution_context& ctx, char* ret_ptr, uint32_t ret_len, const char* arg_ptr, uint32_t arg_len, uint32_t* bytes_written )
          {
             ArgStruct args;
-            ctx.resource_meter().use_compute_bandwidth( ctx.get_compute_bandwidth( "deserialize_message_per_byte" ) * arg_len );
+            ctx.resource_meter().use_compute_bandwidth( ctx.get_compute_bandwidth( compute_cost::deserialize_message_per_byte ) * arg_len );
             args.ParseFromArray( arg_ptr, arg_len );
-            detail::call_thunk_impl< ArgStruct, RetStruct >( thunk, ctx, ret_ptr, ret_len, args, bytes_written );
-         });
-         _pass_through_map.insert_or_assign( id, thunk );
+            detail::call_thunk_impl< ArgStruct, RetStruct >( thunk_ptr, fields, ctx, ret_ptr, ret_len, args, bytes_written );
+         };
+         entry.pass_through = thunk;
       }
 
       template< typename ArgStruct, typename RetStruct, typename ThunkReturn, typename... ThunkArgs >
       void register_genesis_thunk( uint32_t id, ThunkReturn (*thunk_ptr)(execution_context&, ThunkArgs...) )
       {
          register_thunk< ArgStruct, RetStruct, ThunkReturn, ThunkArgs... >( id, thunk_ptr );
-         _genesis_thunks.insert( id );
+         get_or_create_entry( id ).genesis = true;
       }
 
       bool thunk_exists( uint32_t id ) const;
@@ -346,9 +197,18 @@ class thunk_dispatcher
 
       typedef std::function< void(execution_context&, char* ret_ptr, uint32_t ret_len, const char* arg_ptr, uint32_t arg_len, uint32_t* bytes_written) > generic_thunk_handler;
 
-      std::map< int32_t, generic_thunk_handler > _dispatch_map;
-      std::map< int32_t, std::any >              _pass_through_map;
-      std::set< uint32_t >                       _genesis_thunks;
+      struct thunk_entry
+      {
+         generic_thunk_handler handler;
+         std::any              pass_through;
+         bool                  genesis = false;
+      };
+
+      // Thunk ids are small and dense, so thunks are stored in a table indexed directly by id
+      const thunk_entry* get_entry( uint32_t id ) const;
+      thunk_entry& get_or_create_entry( uint32_t id );
+
+      std::vector< thunk_entry > _thunks;
 };
 
 } // koinos::chain
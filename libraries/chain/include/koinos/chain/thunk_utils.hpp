@@ -10,6 +10,7 @@
 #include <koinos/util/conversion.hpp>
 
 #include <type_traits>
+#include <utility>
 
 // This file exposes seven public macros for consumption
 // 1. SYSTEM_CALL_DEFAULTS
@@ -41,7 +42,7 @@ data.register_thunk<BOOST_PP_CAT(elem,_THUNK_ARGS_SUFFIX),BOOST_PP_CAT(elem,_THU
    BOOST_PP_IF(                                                                                      \
       _THUNK_IS_VOID(return_type),                                                                   \
       void,                                                                                          \
-      std::remove_reference_t< decltype( std::declval< return_type >().value() ) >                   \
+      koinos::chain::detail::thunk_value_t< return_type >                                            \
    ) name( execution_context& VA_ARGS(__VA_ARGS__) ); }
 
 #define THUNK_DECLARE_VOID(return_type, name)                                      \
@@ -50,7 +51,7 @@ data.register_thunk<BOOST_PP_CAT(elem,_THUNK_ARGS_SUFFIX),BOOST_PP_CAT(elem,_THU
    BOOST_PP_IF(                                                                    \
       _THUNK_IS_VOID(return_type),                                                 \
       void,                                                                        \
-      std::remove_reference_t< decltype( std::declval<return_type>().value() ) >   \
+      koinos::chain::detail::thunk_value_t< return_type >                          \
    ) name( execution_context& ); }
 
 #define _THUNK_RET_TYPE_void 1)(1
@@ -75,6 +76,20 @@ data.register_thunk<BOOST_PP_CAT(elem,_THUNK_ARGS_SUFFIX),BOOST_PP_CAT(elem,_THU
 #define _THUNK_DETAIL_DEFINE_TYPES(args) BOOST_PP_SEQ_FOR_EACH_I(_THUNK_DETAIL_DEFINE_TYPES_EACH, data, BOOST_PP_VARIADIC_TO_SEQ args)
 
 namespace koinos::chain::detail {
+   // The value a system call returns from its thunk's result message
+   template< typename Result >
+   using thunk_value_t = std::decay_t< decltype( std::declval< Result >().value() ) >;
+
+   // Moves the value out of a result message rather than copying it
+   template< typename Result >
+   thunk_value_t< Result > take_value( Result& ret )
+   {
+      if constexpr ( std::is_reference_v< decltype( ret.value() ) > )
+         return std::move( *ret.mutable_value() );
+      else
+         return ret.value();
+   }
+
    inline void set_message_field( google::protobuf::Message& msg, uint32_t index, int64_t value )
    {
       auto desc = msg.GetDescriptor();
@@ -243,7 +258,7 @@ namespace koinos::chain::detail {
       BOOST_PP_IF(                                                                                                         \
          _THUNK_IS_VOID(RETURN_TYPE),                                                                                      \
          void,                                                                                                             \
-         std::remove_reference_t< decltype( std::declval<RETURN_TYPE>().value() ) >                                        \
+         koinos::chain::detail::thunk_value_t< RETURN_TYPE >                                                               \
       )                                                                                                                    \
    {                                                                                                                       \
                                                                                                                            \
@@ -258,13 +273,14 @@ namespace koinos::chain::detail {
             .call_privilege = privilege::kernel_mode                                                                       \
          },                                                                                                                \
          [&]() {                                                                                                           \
-            if ( context.system_call_exists( _sid ) )                                                                      \
+            const auto& _target = context.resolve_system_call( _sid );                                                     \
+            if ( const auto* _call_bundle = std::get_if< system_call_cache_bundle >( &_target ) )                          \
             {                                                                                                              \
                BOOST_PP_CAT( SYSCALL, _THUNK_ARGS_SUFFIX ) _args;                                                          \
                BOOST_PP_IF(BOOST_VMD_IS_EMPTY(FWD),,_THUNK_ARG_PACK(FWD));                                                 \
                std::string _arg_str;                                                                                       \
                _args.SerializeToString( &_arg_str );                                                                       \
-               const auto& _res = context.system_call( _sid, _arg_str );                                                   \
+               const auto& _res = context.system_call( *_call_bundle, _arg_str );                                          \
                if ( _res.code )                                                                                            \
                {                                                                                                           \
                   if ( _res.code >= chain::reversion )                                                                     \
@@ -278,24 +294,32 @@ namespace koinos::chain::detail {
             }                                                                                                              \
             else                                                                                                           \
             {                                                                                                              \
-               auto _thunk_id = context.thunk_translation( _sid );                                                         \
-               auto _desc = chain::system_call_id_descriptor();                                                            \
-               auto _enum_value = _desc->FindValueByNumber( _thunk_id );                                                   \
-               KOINOS_ASSERT( _enum_value, unknown_thunk_exception, "unrecognized thunk id ${id}", ("id", _thunk_id) );    \
-               auto _compute = context.get_compute_bandwidth( _enum_value->name() );                                       \
-               context.resource_meter().use_compute_bandwidth( _compute );                                                 \
-               BOOST_PP_IF(_THUNK_IS_VOID(RETURN_TYPE),,_ret =)                                                            \
-                  thunk_dispatcher::instance().call_thunk<                                                                 \
-                     RETURN_TYPE                                                                                           \
-                     TYPES >(                                                                                              \
-                        _thunk_id,                                                                                         \
-                        context                                                                                            \
-                        FWD );                                                                                             \
+               const auto& _thunk_bundle = std::get< thunk_cache_bundle >( _target );                                      \
+               auto _thunk_id = context.thunk_translation( _sid, _thunk_bundle );                                          \
+               context.resource_meter().use_compute_bandwidth( context.get_thunk_compute_bandwidth( _thunk_id ) );         \
+               /* Without an override the thunk is this system call's own, so it is called directly */                     \
+               if ( !_thunk_bundle.is_override )                                                                           \
+               {                                                                                                           \
+                  BOOST_PP_IF(_THUNK_IS_VOID(RETURN_TYPE),,_ret =)                                                         \
+                     thunk::BOOST_PP_CAT(_, SYSCALL)( context FWD );                                                       \
+               }                                                                                                           \
+               else                                                                                                        \
+               {                                                                                                           \
+                  BOOST_PP_IF(_THUNK_IS_VOID(RETURN_TYPE),,_ret =)                                                         \
+                     thunk_dispatcher::instance().call_thunk<                                                              \
+                        RETURN_TYPE                                                                                        \
+                        TYPES >(                                                                                           \
+                           _thunk_id,                                                                                      \
+                           context                                                                                         \
+                           FWD );                                                                                          \
+               }                                                                                                           \
+               if ( _sid == system_call_id::exit )                                                                         \
+                  throw chain::success_exception( chain::success );                                                        \
             }                                                                                                              \
          }                                                                                                                 \
       );                                                                                                                   \
                                                                                                                            \
-      BOOST_PP_IF(_THUNK_IS_VOID(RETURN_TYPE),,return _ret.value();)                                                       \
+      BOOST_PP_IF(_THUNK_IS_VOID(RETURN_TYPE),,return koinos::chain::detail::take_value( _ret );)                          \
    }                                                                                                                       \
    }                                                                                                                       \
    namespace thunk {                                                                                                       \
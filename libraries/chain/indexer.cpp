@@ -1,6 +1,7 @@
 #include <koinos/chain/indexer.hpp>
 
 #include <algorithm>
+#include <thread>
 
 #include <koinos/chain/exceptions.hpp>
 #include <koinos/exception.hpp>
@@ -9,11 +10,22 @@
 
 namespace koinos::chain {
 
-indexer::indexer( boost::asio::io_context& ioc, controller& c, std::shared_ptr< mq::client > mc ) :
+static constexpr uint64_t stats_interval     = 10000;
+static constexpr auto     request_timeout    = std::chrono::milliseconds( 5000 );
+
+// Weight given to the newest sample in the moving averages that drive batch sizing
+static constexpr double   sample_weight      = 0.2;
+
+indexer::indexer( boost::asio::io_context& ioc, controller& c, std::shared_ptr< mq::client > mc, uint32_t max_requests, uint64_t max_queued_bytes ) :
    _ioc( ioc ),
    _controller( c ),
    _client( mc ),
-   _signals( ioc )
+   _signals( ioc ),
+   _max_requests( std::max( max_requests, 1u ) ),
+   _max_queued_bytes( max_queued_bytes ),
+   _request_queue( _max_requests ),
+   _batch_sizer( _max_requests, _max_queued_bytes, request_timeout ),
+   _prepare_pool( std::max( 2u, std::thread::hardware_concurrency() ) - 1 )
 {
    _signals.add( SIGINT );
    _signals.add( SIGTERM );
@@ -33,9 +45,23 @@ indexer::indexer( boost::asio::io_context& ioc, controller& c, std::shared_ptr<
 
       _request_queue.close();
       _block_queue.close();
+      _queue_memory_cv.notify_all();
    } );
 }
 
+indexer::~indexer()
+{
+   _stopped = true;
+   _request_queue.close();
+   _block_queue.close();
+   _queue_memory_cv.notify_all();
+
+   // The index thread starts the stage threads, so it is joined first
+   for ( auto* t : { &_index_thread, &_send_thread, &_request_thread, &_apply_thread } )
+      if ( t->joinable() )
+         t->join();
+}
+
 void indexer::handle_error( const std::string& msg )
 {
    _stopped = true;
@@ -48,12 +74,14 @@ void indexer::handle_error( const std::string& msg )
 
    _request_queue.close();
    _block_queue.close();
+   _queue_memory_cv.notify_all();
 }
 
 std::future< bool > indexer::index()
 {
-   boost::asio::post( std::bind( &indexer::prepare_index, this ) );
-   return _complete->get_future();
+   auto result = _complete->get_future();
+   _index_thread = std::thread( [this]() { prepare_index(); } );
+   return result;
 }
 
 void indexer::prepare_index()
@@ -89,8 +117,9 @@ void indexer::prepare_index()
       if ( _start_head_info.head_topology().height() < _target_head.height() )
       {
          LOG(info) << "Indexing to target block - Height: " << _target_head.height() << ", ID: " << util::to_hex( _target_head.id() );
-         boost::asio::post( std::bind( &indexer::send_requests, this, _start_head_info.head_topology().height(), 50 ) );
-         boost::asio::post( std::bind( &indexer::process_block, this ) );
+         _send_thread    = std::thread( [this]() { send_requests( _start_head_info.head_topology().height() ); } );
+         _request_thread = std::thread( [this]() { process_requests(); } );
+         _apply_thread   = std::thread( [this]() { process_block(); } );
       }
       else
       {
@@ -109,35 +138,41 @@ void indexer::prepare_index()
    }
 }
 
-void indexer::send_requests( uint64_t last_height, uint64_t batch_size )
+void indexer::send_requests( uint64_t last_height )
 {
    try
    {
-      if ( _stopped )
-         return;
-
-      if ( last_height <= _target_head.height() )
+      while ( !_stopped )
       {
+         if ( last_height >= _target_head.height() )
+         {
+            _request_queue.close();
+            return;
+         }
+
+         block_request request;
+         request.num_blocks     = std::min( _batch_sizer.next_batch_size(), _target_head.height() - last_height );
+         request.reserved_bytes = reserve_queue_memory( request.num_blocks );
+
+         if ( _stopped )
+            return;
+
          rpc::block_store::block_store_request req;
          auto* by_height_req = req.mutable_get_blocks_by_height();
          by_height_req->set_head_block_id( _target_head.id() );
          by_height_req->set_ancestor_start_height( last_height + 1 );
-         by_height_req->set_num_blocks( uint32_t( batch_size ) );
+         by_height_req->set_num_blocks( uint32_t( request.num_blocks ) );
          by_height_req->set_return_block( true );
          by_height_req->set_return_receipt( false );
 
-         std::shared_future< std::string > data;
+         request.sent     = std::chrono::steady_clock::now();
+         request.response = _client->rpc( util::service::block_store, req.SerializeAsString(), request_timeout );
 
-         data = _client->rpc( util::service::block_store, req.SerializeAsString(), std::chrono::milliseconds( 5000 ) );
+         last_height += request.num_blocks;
 
-         _request_queue.push( std::move( data ) );
-      }
-      else
-      {
-         _requests_complete = true;
+         // Blocks once the maximum number of requests are in flight
+         _request_queue.push_back( std::move( request ) );
       }
-
-      boost::asio::dispatch( std::bind( &indexer::process_requests, this, last_height, batch_size ) );
    }
    catch ( boost::sync_queue_is_closed& )
    {
@@ -153,37 +188,47 @@ void indexer::send_requests( uint64_t last_height, uint64_t batch_size )
    }
 }
 
-void indexer::process_requests( uint64_t last_height, uint64_t batch_size )
+void indexer::process_requests()
 {
    try
    {
-      if ( _stopped )
-         return;
-
-      if ( _requests_complete && _request_queue.empty() )
+      while ( !_stopped )
       {
-         _request_processing_complete = true;
-         return;
-      }
+         block_request request;
 
-      auto fut = _request_queue.pull();
+         if ( _request_queue.wait_pull_front( request ) == boost::concurrent::queue_op_status::closed )
+         {
+            // Blocks already queued can still be pulled, the apply stage finishes once the queue drains
+            _block_queue.close();
+            return;
+         }
 
-      rpc::block_store::block_store_response resp;
-      rpc::block_store::get_blocks_by_height_response by_height_resp;
+         // Only time responses we actually waited on. A response that was ready before we got to it says
+         // nothing about round trip time.
+         std::optional< std::chrono::steady_clock::duration > latency;
+         if ( request.response.wait_for( std::chrono::seconds( 0 ) ) != std::future_status::ready )
+         {
+            request.response.wait();
+            latency = std::chrono::steady_clock::now() - request.sent;
+         }
 
-      if ( !resp.ParseFromString( fut.get() ) )
-         return handle_error( "could not parse block store response" );
+         const auto& data = request.response.get();
+         rpc::block_store::block_store_response resp;
 
-      if ( resp.has_error() )
-         return handle_error( resp.error().message() );
+         if ( !resp.ParseFromString( data ) )
+            return handle_error( "could not parse block store response" );
 
-      if ( !resp.has_get_blocks_by_height() )
-         return handle_error( "unexpected block store response" );
+         if ( resp.has_error() )
+            return handle_error( resp.error().message() );
+
+         if ( !resp.has_get_blocks_by_height() )
+            return handle_error( "unexpected block store response" );
 
-      for ( auto& block_item : *resp.mutable_get_blocks_by_height()->mutable_block_items() )
-         _block_queue.push( std::move( *block_item.mutable_block() ) );
+         _batch_sizer.update( request.num_blocks, data.size(), latency, _blocks_applied.load() );
+         release_queue_memory( request.reserved_bytes );
 
-      boost::asio::post( std::bind( &indexer::send_requests, this, last_height + batch_size, std::min( batch_size * 2, uint64_t( 1000 ) ) ) );
+         prepare_blocks( std::move( *resp.mutable_get_blocks_by_height() ) );
+      }
    }
    catch ( boost::sync_queue_is_closed& )
    {
@@ -199,30 +244,167 @@ void indexer::process_requests( uint64_t last_height, uint64_t batch_size )
    }
 }
 
-void indexer::process_block()
+void indexer::prepare_blocks( rpc::block_store::get_blocks_by_height_response&& resp )
 {
-   try
+   _blocks_fetched += resp.block_items_size();
+
+   for ( auto& block_item : *resp.mutable_block_items() )
    {
-      if ( _stopped )
-         return;
+      queued_block queued;
+      queued.bytes = block_item.block().ByteSizeLong();
 
-      if ( _request_processing_complete && _block_queue.empty() )
       {
-         const auto new_head_info = _controller.get_head_info();
-         const std::chrono::duration< double > duration = std::chrono::system_clock::now() - _start_time;
-         LOG(info) << "Finished indexing " << new_head_info.head_topology().height() - _start_head_info.head_topology().height() << " blocks, took " << duration.count() << " seconds";
-         _complete->set_value( true );
-         _complete.reset();
-         return;
+         std::lock_guard< std::mutex > lock( _queue_memory_mutex );
+         _queued_bytes += queued.bytes;
       }
 
-      rpc::chain::submit_block_request submit_block;
+      auto task = std::make_shared< std::packaged_task< std::shared_ptr< const prepared_block >() > >(
+         [this, block = std::move( *block_item.mutable_block() )]() mutable
+         {
+            auto prepared = _controller.prepare_block( std::move( block ) );
+            _blocks_prepared++;
+            return prepared;
+         }
+      );
+
+      // Futures are queued in block order so preparation can complete out of order
+      queued.block = task->get_future().share();
+      _block_queue.push( std::move( queued ) );
+      boost::asio::post( _prepare_pool, [task]() { ( *task )(); } );
+   }
+}
+
+batch_sizer::batch_sizer( uint32_t max_requests, uint64_t max_queued_bytes, std::chrono::steady_clock::duration request_timeout ) :
+   _max_requests( std::max( max_requests, 1u ) ),
+   _max_queued_bytes( max_queued_bytes ),
+   _request_timeout( std::chrono::duration< double >( request_timeout ).count() )
+{}
+
+uint64_t batch_sizer::next_batch_size()
+{
+   std::lock_guard< std::mutex > lock( _mutex );
+
+   if ( !_last_batch_size )
+      return _last_batch_size = initial_batch_size;
+
+   // Grow by at most 2x per request so that early estimates cannot overshoot
+   double batch_size = double( _last_batch_size ) * 2;
 
-      *submit_block.mutable_block() = _block_queue.pull();
-      _controller.submit_block( submit_block, _target_head.height() );
+   // Enough blocks must be in flight to cover a round trip at the current apply rate
+   if ( _avg_apply_rate > 0 && _avg_latency > 0 )
+      batch_size = std::min( batch_size, std::max( _avg_apply_rate * _avg_latency * 2 / _max_requests, double( min_batch_size ) ) );
 
+   // Keep round trips well clear of the request timeout
+   if ( _avg_latency > _request_timeout / 2 )
+      batch_size = std::min( batch_size, double( _last_batch_size ) * _request_timeout / ( 2 * _avg_latency ) );
 
-      boost::asio::post( std::bind( &indexer::process_block, this ) );
+   // Every in flight request must fit in the queue memory ceiling
+   if ( _avg_block_bytes > 0 )
+      batch_size = std::min( batch_size, double( _max_queued_bytes ) / ( _avg_block_bytes * _max_requests ) );
+
+   _last_batch_size = std::clamp( uint64_t( batch_size ), min_batch_size, max_batch_size );
+   return _last_batch_size;
+}
+
+void batch_sizer::update(
+   uint64_t num_blocks,
+   uint64_t response_bytes,
+   std::optional< std::chrono::steady_clock::duration > latency,
+   uint64_t blocks_applied,
+   std::chrono::steady_clock::time_point now )
+{
+   std::lock_guard< std::mutex > lock( _mutex );
+
+   auto average = []( double avg, double sample )
+   {
+      return avg > 0 ? avg + sample_weight * ( sample - avg ) : sample;
+   };
+
+   if ( num_blocks )
+      _avg_block_bytes = average( _avg_block_bytes, double( response_bytes ) / num_blocks );
+
+   if ( latency )
+      _avg_latency = average( _avg_latency, std::chrono::duration< double >( *latency ).count() );
+
+   // The first response only starts the apply rate measurement
+   if ( !_last_apply_sample_time )
+   {
+      _last_applied_sample = blocks_applied;
+      _last_apply_sample_time = now;
+      return;
+   }
+
+   const std::chrono::duration< double > elapsed = now - *_last_apply_sample_time;
+
+   if ( blocks_applied > _last_applied_sample && elapsed.count() > 0 )
+   {
+      _avg_apply_rate = average( _avg_apply_rate, ( blocks_applied - _last_applied_sample ) / elapsed.count() );
+      _last_applied_sample = blocks_applied;
+      _last_apply_sample_time = now;
+   }
+}
+
+double batch_sizer::average_block_bytes()
+{
+   std::lock_guard< std::mutex > lock( _mutex );
+   return _avg_block_bytes;
+}
+
+uint64_t indexer::reserve_queue_memory( uint64_t num_blocks )
+{
+   const auto bytes = uint64_t( _batch_sizer.average_block_bytes() * num_blocks );
+
+   std::unique_lock< std::mutex > lock( _queue_memory_mutex );
+
+   // An empty queue always admits a request so a single oversized batch cannot stall indexing
+   _queue_memory_cv.wait( lock, [&]()
+   {
+      return _stopped || !_queued_bytes || _queued_bytes + bytes <= _max_queued_bytes;
+   } );
+
+   _queued_bytes += bytes;
+   return bytes;
+}
+
+void indexer::release_queue_memory( uint64_t bytes )
+{
+   {
+      std::lock_guard< std::mutex > lock( _queue_memory_mutex );
+      _queued_bytes -= std::min( bytes, _queued_bytes );
+   }
+
+   _queue_memory_cv.notify_all();
+}
+
+void indexer::process_block()
+{
+   try
+   {
+      while ( !_stopped )
+      {
+         queued_block queued;
+
+         if ( _block_queue.wait_pull( queued ) == boost::concurrent::queue_op_status::closed )
+         {
+            if ( _stopped )
+               return;
+
+            log_stats();
+            const auto new_head_info = _controller.get_head_info();
+            const std::chrono::duration< double > duration = std::chrono::system_clock::now() - _start_time;
+            LOG(info) << "Finished indexing " << new_head_info.head_topology().height() - _start_head_info.head_topology().height() << " blocks, took " << duration.count() << " seconds";
+            _complete->set_value( true );
+            _complete.reset();
+            return;
+         }
+
+         // Rethrows any validation failure from the prepare stage
+         _controller.submit_block( *queued.block.get(), _target_head.height() );
+         release_queue_memory( queued.bytes );
+
+         if ( ++_blocks_applied % stats_interval == 0 )
+            log_stats();
+      }
    }
    catch ( boost::sync_queue_is_closed& )
    {
@@ -238,4 +420,15 @@ void indexer::process_block()
    }
 }
 
+void indexer::log_stats()
+{
+   const std::chrono::duration< double > duration = std::chrono::system_clock::now() - _start_time;
+   const auto seconds = std::max( duration.count(), 1.0 );
+
+   LOG(info) << "Indexer pipeline - Fetched: " << _blocks_fetched.load() << " (" << uint64_t( _blocks_fetched.load() / seconds ) << " blocks/s)"
+             << ", Prepared: " << _blocks_prepared.load() << " (" << uint64_t( _blocks_prepared.load() / seconds ) << " blocks/s)"
+             << ", Applied: " << _blocks_applied.load() << " (" << uint64_t( _blocks_applied.load() / seconds ) << " blocks/s)"
+             << ", Queued: " << _block_queue.size() << " blocks";
+}
+
 } // koinos::chain
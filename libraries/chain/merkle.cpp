@@ -0,0 +1,37 @@
+#include <koinos/chain/merkle.hpp>
+
+#include <koinos/chain/exceptions.hpp>
+#include <koinos/chain/sha256.hpp>
+
+#include <cstring>
+
+namespace koinos::chain::merkle {
+
+std::string_view sha256_merkle_root( std::string& digests )
+{
+   KOINOS_ASSERT(
+      digests.size() && digests.size() % sha256::digest_size == 0,
+      internal_error_exception,
+      "merkle leaves must be a non-empty sequence of sha256 digests"
+   );
+
+   auto* data = digests.data();
+   auto count = digests.size() / sha256::digest_size;
+
+   while ( count > 1 )
+   {
+      const auto pairs = count / 2;
+
+      // Digests of a level are written over the front of the previous level
+      sha256::hash_pairs( data, data, pairs );
+
+      if ( count % 2 )
+         std::memmove( data + pairs * sha256::digest_size, data + ( count - 1 ) * sha256::digest_size, sha256::digest_size );
+
+      count = pairs + count % 2;
+   }
+
+   return std::string_view( data, sha256::digest_size );
+}
+
+} // koinos::chain::merkle
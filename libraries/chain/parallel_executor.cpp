@@ -0,0 +1,238 @@
+#include <koinos/chain/parallel_executor.hpp>
+
+#include <koinos/chain/exceptions.hpp>
+#include <koinos/chain/system_calls.hpp>
+
+#include <koinos/util/conversion.hpp>
+#include <koinos/util/hex.hpp>
+
+#include <boost/asio/post.hpp>
+
+#include <future>
+#include <memory>
+#include <vector>
+
+namespace koinos::chain {
+
+void state_access_set::record_read( const object_space& space, const std::string& key )
+{
+   reads.emplace( util::converter::as< std::string >( space ), key );
+}
+
+void state_access_set::record_write( const object_space& space, const std::string& key )
+{
+   writes.emplace( util::converter::as< std::string >( space ), key );
+}
+
+void state_access_set::record_range_read( const object_space& space )
+{
+   range_reads.emplace( util::converter::as< std::string >( space ) );
+}
+
+bool state_access_set::conflicts_with( const state_access_set& other ) const
+{
+   // Writes conflict as well, the disk storage a write is charged depends on the previous value
+   for ( const auto& key : reads )
+      if ( other.writes.count( key ) )
+         return true;
+
+   for ( const auto& key : writes )
+      if ( other.writes.count( key ) )
+         return true;
+
+   for ( const auto& space : range_reads )
+   {
+      auto itr = other.writes.lower_bound( key_type( space, std::string() ) );
+      if ( itr != other.writes.end() && itr->first == space )
+         return true;
+   }
+
+   return false;
+}
+
+void state_access_set::merge_writes( const state_access_set& other )
+{
+   writes.insert( other.writes.begin(), other.writes.end() );
+}
+
+namespace detail {
+
+struct speculation
+{
+   anonymous_state_node_ptr             node;
+   std::shared_ptr< state_access_set >  access = std::make_shared< state_access_set >();
+   std::unique_ptr< execution_context > ctx;
+   bool                                 valid = false;
+};
+
+struct state_access_guard
+{
+   state_access_guard( execution_context& context, std::shared_ptr< state_access_set > access ) :
+      ctx( context )
+   {
+      ctx.set_state_access( std::move( access ) );
+   }
+
+   ~state_access_guard()
+   {
+      ctx.set_state_access( nullptr );
+   }
+
+   execution_context& ctx;
+};
+
+void speculate(
+   speculation& spec,
+   const execution_context& ctx,
+   const resource_meter& start_meter,
+   abstract_state_node_ptr parent,
+   const protocol::block& block,
+   const protocol::transaction& trx ) noexcept
+{
+   try
+   {
+      spec.ctx = std::make_unique< execution_context >( ctx.get_backend(), intent::block_application );
+
+      auto& spec_ctx = *spec.ctx;
+      spec_ctx.set_state_node( spec.node, parent );
+      spec_ctx.set_cache( ctx.cache() );
+      spec_ctx.set_signature_cache( ctx.signature_cache() );
+      spec_ctx.set_serialized_block( ctx.get_serialized_block() );
+      spec_ctx.set_state_access( spec.access );
+      spec_ctx.set_block( block );
+      spec_ctx.resource_meter() = start_meter;
+      spec_ctx.resource_meter().mark();
+      spec_ctx.receipt() = protocol::block_receipt();
+
+      // The same frames apply_transaction runs under during block application
+      spec_ctx.push_frame( stack_frame {
+         .call_privilege = privilege::kernel_mode
+      } );
+
+      spec_ctx.push_frame( stack_frame {
+         .sid = static_cast< uint32_t >( system_call_id::apply_block ),
+         .call_privilege = privilege::kernel_mode
+      } );
+
+      try
+      {
+         system_call::apply_transaction( spec_ctx, trx );
+      }
+      catch ( const reversion_exception& ) {}
+
+      spec.valid = std::get< protocol::block_receipt >( spec_ctx.receipt() ).transaction_receipts_size() == 1;
+   }
+   catch ( ... ) {}
+}
+
+// Commits a speculative transaction into the block, returns false without modifying the block if it cannot be
+bool commit( execution_context& ctx, const resource_meter& start_meter, speculation& spec )
+{
+   auto& spec_ctx = *spec.ctx;
+
+   if ( !ctx.resource_meter().merge( start_meter, spec_ctx.resource_meter() ) )
+      return false;
+
+   spec.node->commit();
+
+   if ( spec_ctx.cache_stale() )
+      ctx.mark_cache_stale();
+
+   // Event sequence numbers are numbered across the block
+   const auto sequence_offset = uint32_t( ctx.chronicler().events().size() );
+
+   for ( const auto& [ transaction_id, event ] : spec_ctx.chronicler().events() )
+      ctx.chronicler().push_event( transaction_id, protocol::event_data( event ) );
+
+   for ( const auto& message : spec_ctx.chronicler().logs() )
+      ctx.chronicler().push_log( message );
+
+   auto& receipt = *std::get< protocol::block_receipt >( spec_ctx.receipt() ).mutable_transaction_receipts( 0 );
+
+   for ( auto& event : *receipt.mutable_events() )
+      event.set_sequence( event.sequence() + sequence_offset );
+
+   // Transaction receipts hold the delta of the block up to and including the transaction
+   receipt.clear_state_delta_entries();
+   for ( const auto& entry : ctx.get_state_node()->get_delta_entries() )
+      *receipt.add_state_delta_entries() = entry;
+
+   *std::get< protocol::block_receipt >( ctx.receipt() ).add_transaction_receipts() = std::move( receipt );
+
+   return true;
+}
+
+} // detail
+
+parallel_executor::parallel_executor( boost::asio::thread_pool& pool ) :
+   _pool( pool ) {}
+
+void parallel_executor::apply_transactions( execution_context& ctx, const protocol::block& block )
+{
+   const auto& transactions = block.transactions();
+   const auto block_node    = ctx.get_state_node();
+   const auto parent_node   = ctx.get_parent_node();
+   const auto start_meter   = ctx.resource_meter();
+
+   std::vector< detail::speculation > specs( transactions.size() );
+   std::vector< std::future< void > > pending;
+   pending.reserve( specs.size() );
+
+   // Nodes are created on this thread, the pool only executes transactions. Nothing writes
+   // to the block node until every speculation has finished.
+   for ( int i = 0; i < transactions.size(); i++ )
+   {
+      specs[ i ].node = block_node->create_anonymous_node();
+
+      auto done = std::make_shared< std::promise< void > >();
+      pending.emplace_back( done->get_future() );
+
+      boost::asio::post( _pool, [&, i, done]()
+      {
+         detail::speculate( specs[ i ], ctx, start_meter, parent_node, block, transactions[ i ] );
+         done->set_value();
+      } );
+   }
+
+   for ( auto& f : pending )
+      f.wait();
+
+   state_access_set written;
+
+   for ( int i = 0; i < transactions.size(); i++ )
+   {
+      auto& spec = specs[ i ];
+
+      if ( spec.valid && !spec.access->conflicts_with( written ) && detail::commit( ctx, start_meter, spec ) )
+      {
+         written.merge_writes( *spec.access );
+         _speculated++;
+         continue;
+      }
+
+      spec.node.reset();
+
+      auto access = std::make_shared< state_access_set >();
+
+      try
+      {
+         detail::state_access_guard guard( ctx, access );
+         system_call::apply_transaction( ctx, transactions[ i ] );
+      }
+      catch ( const reversion_exception& ) {} /* do nothing */
+      KOINOS_CAPTURE_CATCH_AND_RETHROW( ("transaction_id", util::to_hex( transactions[ i ].id() )) )
+
+      written.merge_writes( *access );
+      _reexecuted++;
+   }
+}
+
+parallel_executor_stats parallel_executor::stats() const
+{
+   parallel_executor_stats result;
+   result.speculated = _speculated;
+   result.reexecuted = _reexecuted;
+   return result;
+}
+
+} // koinos::chain
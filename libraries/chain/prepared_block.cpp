@@ -0,0 +1,57 @@
+#include <koinos/chain/prepared_block.hpp>
+
+#include <koinos/util/conversion.hpp>
+
+namespace koinos::chain {
+
+bool serialized_block::describes( const protocol::block& b ) const
+{
+   return source == &b;
+}
+
+const serialized_transaction* serialized_block::find( const protocol::transaction& trx ) const
+{
+   auto itr = index.find( &trx );
+   if ( itr == index.end() )
+      return nullptr;
+
+   return &transactions[ itr->second ];
+}
+
+serialized_transaction serialize_transaction( const protocol::transaction& trx )
+{
+   serialized_transaction serialized;
+   serialized.header = util::converter::as< std::string >( trx.header() );
+   serialized.size   = trx.ByteSizeLong();
+
+   for ( const auto& sig : trx.signatures() )
+      serialized.signatures += sig;
+
+   serialized.operations.reserve( trx.operations_size() );
+   for ( const auto& op : trx.operations() )
+      serialized.operations.emplace_back( util::converter::as< std::string >( op ) );
+
+   return serialized;
+}
+
+serialized_block serialize_block( const protocol::block& block )
+{
+   serialized_block serialized;
+   serialized.source = &block;
+   serialized.header = util::converter::as< std::string >( block.header() );
+   serialized.block  = util::converter::as< std::string >( block );
+
+   serialized.transactions.reserve( block.transactions_size() );
+   serialized.index.reserve( block.transactions_size() );
+
+   for ( const auto& trx : block.transactions() )
+   {
+      serialized.index.emplace( &trx, serialized.transactions.size() );
+      serialized.transactions.emplace_back( serialize_transaction( trx ) );
+      serialized.transactions_size += serialized.transactions.back().size;
+   }
+
+   return serialized;
+}
+
+} // koinos::chain
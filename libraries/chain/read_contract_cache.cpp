@@ -0,0 +1,142 @@
+#include <koinos/chain/read_contract_cache.hpp>
+
+#include <koinos/chain/sha256.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace koinos::chain {
+
+namespace detail {
+
+void append_field( std::string& key, const std::string& field )
+{
+   // Fields are prefixed with their length so that different fields never produce the same key
+   auto size = uint32_t( field.size() );
+   key.append( reinterpret_cast< const char* >( &size ), sizeof( size ) );
+   key.append( field );
+}
+
+std::string read_contract_key( const std::string& head_id, const rpc::chain::read_contract_request& request )
+{
+   std::string key;
+   key.reserve( head_id.size() + request.contract_id().size() + 3 * sizeof( uint32_t ) + sha256::digest_size );
+
+   append_field( key, head_id );
+   append_field( key, request.contract_id() );
+
+   auto entry_point = request.entry_point();
+   key.append( reinterpret_cast< const char* >( &entry_point ), sizeof( entry_point ) );
+
+   auto digest_offset = key.size();
+   key.resize( digest_offset + sha256::digest_size );
+   sha256::hash_many( { &request.args() }, key.data() + digest_offset );
+
+   return key;
+}
+
+} // detail
+
+read_contract_cache::read_contract_cache( std::size_t max_entries ) :
+   _max_entries( std::max( max_entries, std::size_t( 1 ) ) )
+{}
+
+void read_contract_cache::set_head( const std::string& head_id )
+{
+   std::lock_guard< std::mutex > lock( _mutex );
+
+   if ( head_id == _head_id )
+      return;
+
+   _head_id = head_id;
+   _entries.clear();
+   _lru_list.clear();
+}
+
+rpc::chain::read_contract_response read_contract_cache::get(
+   const std::string& head_id,
+   const rpc::chain::read_contract_request& request,
+   const execute_function& execute )
+{
+   auto key = detail::read_contract_key( head_id, request );
+
+   std::shared_ptr< std::promise< rpc::chain::read_contract_response > > result;
+   std::shared_future< rpc::chain::read_contract_response > pending;
+
+   {
+      std::lock_guard< std::mutex > lock( _mutex );
+
+      if ( auto itr = _entries.find( key ); itr != _entries.end() )
+      {
+         _lru_list.splice( _lru_list.begin(), _lru_list, itr->second );
+         _hits++;
+         return itr->second->response;
+      }
+
+      if ( auto itr = _in_flight.find( key ); itr != _in_flight.end() )
+      {
+         pending = itr->second;
+         _shared++;
+      }
+      else
+      {
+         result = std::make_shared< std::promise< rpc::chain::read_contract_response > >();
+         _in_flight.emplace( key, result->get_future().share() );
+         _misses++;
+      }
+   }
+
+   if ( pending.valid() )
+      return pending.get();
+
+   try
+   {
+      auto response = execute();
+
+      {
+         std::lock_guard< std::mutex > lock( _mutex );
+         _in_flight.erase( key );
+
+         // A read that finishes after the head has changed is not cached
+         if ( head_id == _head_id && !_entries.count( key ) )
+         {
+            _lru_list.push_front( entry { .key = key, .response = response } );
+            _entries.emplace( key, _lru_list.begin() );
+
+            if ( _entries.size() > _max_entries )
+            {
+               _entries.erase( _lru_list.back().key );
+               _lru_list.pop_back();
+            }
+         }
+      }
+
+      result->set_value( response );
+      return response;
+   }
+   catch ( ... )
+   {
+      {
+         std::lock_guard< std::mutex > lock( _mutex );
+         _in_flight.erase( key );
+      }
+
+      result->set_exception( std::current_exception() );
+      throw;
+   }
+}
+
+read_contract_cache_stats read_contract_cache::stats() const
+{
+   std::lock_guard< std::mutex > lock( _mutex );
+
+   read_contract_cache_stats result;
+   result.hits    = _hits;
+   result.misses  = _misses;
+   result.shared  = _shared;
+   result.entries = _entries.size();
+   return result;
+}
+
+} // koinos::chain
@@ -0,0 +1,143 @@
+#include <koinos/chain/request_scheduler.hpp>
+
+#include <koinos/chain/exceptions.hpp>
+
+#include <boost/asio/post.hpp>
+
+#include <algorithm>
+#include <future>
+#include <memory>
+
+namespace koinos::chain {
+
+const std::string& to_string( request_class c )
+{
+   static const std::array< std::string, num_request_classes > names = { "block", "transaction", "read" };
+   return names.at( std::size_t( c ) );
+}
+
+request_scheduler::request_scheduler( const request_class_config& block, const request_class_config& transaction, const request_class_config& read )
+{
+   auto init = [&]( request_class c, const request_class_config& config )
+   {
+      auto& e = get_executor( c );
+      e.config = config;
+      e.config.threads = std::max( config.threads, std::size_t( 1 ) );
+      e.pool = std::make_unique< boost::asio::thread_pool >( e.config.threads );
+   };
+
+   init( request_class::block, block );
+   init( request_class::transaction, transaction );
+   init( request_class::read, read );
+}
+
+request_scheduler::~request_scheduler()
+{
+   stop();
+}
+
+void request_scheduler::execute( request_class c, const std::function< void() >& function )
+{
+   auto& e = get_executor( c );
+
+   {
+      std::lock_guard< std::mutex > lock( _mutex );
+
+      KOINOS_ASSERT( !_stopped, request_rejected_exception, "chain is shutting down, ${c} request rejected", ("c", to_string( c )) );
+
+      if ( e.config.max_queue_depth && e.stats.queued >= e.config.max_queue_depth )
+      {
+         e.stats.rejected++;
+         KOINOS_THROW(
+            request_rejected_exception,
+            "chain is busy, ${c} request rejected with ${q} ${c} requests queued",
+            ("c", to_string( c ))("q", e.stats.queued)
+         );
+      }
+
+      e.stats.admitted++;
+      e.stats.queued++;
+   }
+
+   auto enqueued = std::chrono::steady_clock::now();
+   auto result = std::make_shared< std::promise< void > >();
+   auto future = result->get_future();
+
+   boost::asio::post( *e.pool, [&, result]()
+   {
+      auto wait = std::chrono::duration_cast< std::chrono::microseconds >( std::chrono::steady_clock::now() - enqueued );
+
+      {
+         std::lock_guard< std::mutex > lock( _mutex );
+         e.stats.queued--;
+         e.stats.executing++;
+         e.stats.total_wait += wait;
+         e.stats.max_wait = std::max( e.stats.max_wait, wait );
+      }
+
+      std::exception_ptr error;
+
+      try
+      {
+         function();
+      }
+      catch ( ... )
+      {
+         error = std::current_exception();
+      }
+
+      {
+         std::lock_guard< std::mutex > lock( _mutex );
+         e.stats.executing--;
+         e.stats.completed++;
+      }
+
+      // The caller may return as soon as the result is set, nothing captured by reference is used after this
+      if ( error )
+         result->set_exception( error );
+      else
+         result->set_value();
+   } );
+
+   future.get();
+}
+
+request_class_stats request_scheduler::stats( request_class c ) const
+{
+   std::lock_guard< std::mutex > lock( _mutex );
+   return get_executor( c ).stats;
+}
+
+std::size_t request_scheduler::capacity( request_class c ) const
+{
+   const auto& config = get_executor( c ).config;
+   return config.threads + config.max_queue_depth;
+}
+
+void request_scheduler::stop()
+{
+   {
+      std::lock_guard< std::mutex > lock( _mutex );
+
+      if ( _stopped )
+         return;
+
+      _stopped = true;
+   }
+
+   // Admitted requests still run, their callers are waiting on them
+   for ( auto& e : _executors )
+      e.pool->join();
+}
+
+request_scheduler::executor& request_scheduler::get_executor( request_class c )
+{
+   return _executors.at( std::size_t( c ) );
+}
+
+const request_scheduler::executor& request_scheduler::get_executor( request_class c ) const
+{
+   return _executors.at( std::size_t( c ) );
+}
+
+} // koinos::chain
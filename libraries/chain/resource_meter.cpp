@@ -4,6 +4,8 @@
 
 #include <boost/multiprecision/cpp_int.hpp>
 
+#include <algorithm>
+
 using int128_t = boost::multiprecision::int128_t;
 
 namespace koinos::chain {
@@ -34,6 +36,7 @@ void resource_meter::set_resource_limit_data( const resource_limit_data& rld )
    _system_network_bandwidth_used = 0;
    _compute_bandwidth_remaining   = _resource_limit_data.compute_bandwidth_limit();
    _system_compute_bandwidth_used = 0;
+   mark();
 }
 
 const resource_limit_data& resource_meter::get_resource_limit_data() const
@@ -60,6 +63,8 @@ void resource_meter::use_disk_storage( int64_t bytes )
       _disk_storage_remaining -= uint64_t( bytes );
    else
       _disk_storage_remaining += uint64_t( -1 * bytes );
+
+   _disk_storage_low = std::min( _disk_storage_low, _disk_storage_remaining );
 }
 
 uint64_t resource_meter::disk_storage_used() const
@@ -105,6 +110,7 @@ void resource_meter::use_network_bandwidth( int64_t bytes )
    }
 
    _network_bandwidth_remaining -= uint64_t( bytes );
+   _network_bandwidth_low = std::min( _network_bandwidth_low, _network_bandwidth_remaining );
 }
 
 uint64_t resource_meter::network_bandwidth_used() const
@@ -147,6 +153,7 @@ void resource_meter::use_compute_bandwidth( int64_t ticks )
    }
 
    _compute_bandwidth_remaining -= uint64_t( ticks );
+   _compute_bandwidth_low = std::min( _compute_bandwidth_low, _compute_bandwidth_remaining );
 }
 
 uint64_t resource_meter::compute_bandwidth_used() const
@@ -161,9 +168,18 @@ uint64_t resource_meter::compute_bandwidth_remaining() const
       auto cost = _resource_limit_data.compute_bandwidth_cost();
 
       if ( cost > 0 )
-         return std::min( session->remaining_rc() / cost, _compute_bandwidth_remaining );
+      {
+         auto session_remaining = session->remaining_rc() / cost;
+
+         if ( session_remaining <= _compute_bandwidth_remaining )
+         {
+            _compute_bandwidth_headroom = std::min( _compute_bandwidth_headroom, _compute_bandwidth_remaining - session_remaining );
+            return session_remaining;
+         }
+      }
    }
 
+   _compute_bandwidth_headroom = 0;
    return _compute_bandwidth_remaining;
 }
 
@@ -177,4 +193,44 @@ void resource_meter::set_session( std::shared_ptr< abstract_rc_session > s )
    _session = s;
 }
 
+void resource_meter::mark()
+{
+   _disk_storage_low           = _disk_storage_remaining;
+   _network_bandwidth_low      = _network_bandwidth_remaining;
+   _compute_bandwidth_low      = _compute_bandwidth_remaining;
+   _compute_bandwidth_headroom = std::numeric_limits< uint64_t >::max();
+}
+
+bool resource_meter::merge( const resource_meter& start, const resource_meter& other )
+{
+   // Limits are checked against the remaining amount before each use, so the usage fits
+   // if the largest amount used at any point fits in what remains here
+   const uint64_t disk_peak    = start._disk_storage_remaining - std::min( start._disk_storage_remaining, other._disk_storage_low );
+   const uint64_t network_peak = start._network_bandwidth_remaining - std::min( start._network_bandwidth_remaining, other._network_bandwidth_low );
+   const uint64_t compute_peak = start._compute_bandwidth_remaining - std::min( start._compute_bandwidth_remaining, other._compute_bandwidth_low );
+
+   if ( disk_peak > _disk_storage_remaining || network_peak > _network_bandwidth_remaining || compute_peak > _compute_bandwidth_remaining )
+      return false;
+
+   // Compute bandwidth remaining is observable as the VM tick limit. It is unchanged as long as the
+   // session stayed the limit, or this meter has exactly as much compute bandwidth remaining as start.
+   if ( start._compute_bandwidth_remaining - std::min( start._compute_bandwidth_remaining, _compute_bandwidth_remaining ) > other._compute_bandwidth_headroom )
+      return false;
+
+   _disk_storage_low      = std::min( _disk_storage_low, _disk_storage_remaining - disk_peak );
+   _network_bandwidth_low = std::min( _network_bandwidth_low, _network_bandwidth_remaining - network_peak );
+   _compute_bandwidth_low = std::min( _compute_bandwidth_low, _compute_bandwidth_remaining - compute_peak );
+
+   // Unsigned arithmetic wraps, so adding the difference is exact even when storage was freed
+   _disk_storage_remaining      += other._disk_storage_remaining - start._disk_storage_remaining;
+   _network_bandwidth_remaining += other._network_bandwidth_remaining - start._network_bandwidth_remaining;
+   _compute_bandwidth_remaining += other._compute_bandwidth_remaining - start._compute_bandwidth_remaining;
+
+   _system_disk_storage_used      += other._system_disk_storage_used - start._system_disk_storage_used;
+   _system_network_bandwidth_used += other._system_network_bandwidth_used - start._system_network_bandwidth_used;
+   _system_compute_bandwidth_used += other._system_compute_bandwidth_used - start._system_compute_bandwidth_used;
+
+   return true;
+}
+
 } // koinos::chain
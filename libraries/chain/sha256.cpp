@@ -0,0 +1,281 @@
+#include <koinos/chain/sha256.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+
+namespace koinos::chain::sha256 {
+
+namespace detail {
+
+constexpr std::array< uint32_t, 64 > k = {
+   0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+   0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+   0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+   0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+   0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+   0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+   0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+   0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+constexpr std::array< uint32_t, 8 > initial_state = {
+   0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+constexpr std::size_t block_size = 64;
+
+constexpr uint32_t rotr( uint32_t x, int n )
+{
+   return ( x >> n ) | ( x << ( 32 - n ) );
+}
+
+constexpr uint32_t big_sigma0( uint32_t x ) { return rotr( x, 2 ) ^ rotr( x, 13 ) ^ rotr( x, 22 ); }
+constexpr uint32_t big_sigma1( uint32_t x ) { return rotr( x, 6 ) ^ rotr( x, 11 ) ^ rotr( x, 25 ); }
+constexpr uint32_t small_sigma0( uint32_t x ) { return rotr( x, 7 ) ^ rotr( x, 18 ) ^ ( x >> 3 ); }
+constexpr uint32_t small_sigma1( uint32_t x ) { return rotr( x, 17 ) ^ rotr( x, 19 ) ^ ( x >> 10 ); }
+
+constexpr uint32_t ch( uint32_t e, uint32_t f, uint32_t g ) { return ( e & f ) ^ ( ~e & g ); }
+constexpr uint32_t maj( uint32_t a, uint32_t b, uint32_t c ) { return ( a & b ) ^ ( a & c ) ^ ( b & c ); }
+
+// A 64 byte message is padded with a second block that is the same for every message,
+// so its message schedule, with the round constants added, is computed once.
+constexpr std::array< uint32_t, 64 > make_padding_schedule()
+{
+   std::array< uint32_t, 64 > w {};
+   w[ 0 ]  = 0x80000000;
+   w[ 15 ] = 512;
+
+   for ( std::size_t i = 16; i < 64; i++ )
+      w[ i ] = small_sigma1( w[ i - 2 ] ) + w[ i - 7 ] + small_sigma0( w[ i - 15 ] ) + w[ i - 16 ];
+
+   for ( std::size_t i = 0; i < 64; i++ )
+      w[ i ] += k[ i ];
+
+   return w;
+}
+
+constexpr std::array< uint32_t, 64 > padding_schedule = make_padding_schedule();
+
+inline uint32_t load_be( const char* p )
+{
+   const auto* b = reinterpret_cast< const unsigned char* >( p );
+   return ( uint32_t( b[ 0 ] ) << 24 ) | ( uint32_t( b[ 1 ] ) << 16 ) | ( uint32_t( b[ 2 ] ) << 8 ) | uint32_t( b[ 3 ] );
+}
+
+inline void store_be( char* p, uint32_t x )
+{
+   auto* b = reinterpret_cast< unsigned char* >( p );
+   b[ 0 ] = static_cast< unsigned char >( x >> 24 );
+   b[ 1 ] = static_cast< unsigned char >( x >> 16 );
+   b[ 2 ] = static_cast< unsigned char >( x >> 8 );
+   b[ 3 ] = static_cast< unsigned char >( x );
+}
+
+template< std::size_t Lanes >
+using lane_state = uint32_t[ 8 ][ Lanes ];
+
+template< std::size_t Lanes >
+void init( lane_state< Lanes >& state )
+{
+   for ( std::size_t j = 0; j < 8; j++ )
+      for ( std::size_t l = 0; l < Lanes; l++ )
+         state[ j ][ l ] = initial_state[ j ];
+}
+
+// Expands a block per lane into its message schedule, with the round constants added
+template< std::size_t Lanes >
+void schedule( const char* const ( &blocks )[ Lanes ], uint32_t ( &w )[ 64 ][ Lanes ] )
+{
+   for ( std::size_t i = 0; i < 16; i++ )
+      for ( std::size_t l = 0; l < Lanes; l++ )
+         w[ i ][ l ] = load_be( blocks[ l ] + i * 4 );
+
+   for ( std::size_t i = 16; i < 64; i++ )
+      for ( std::size_t l = 0; l < Lanes; l++ )
+         w[ i ][ l ] = small_sigma1( w[ i - 2 ][ l ] ) + w[ i - 7 ][ l ] + small_sigma0( w[ i - 15 ][ l ] ) + w[ i - 16 ][ l ];
+
+   for ( std::size_t i = 0; i < 64; i++ )
+      for ( std::size_t l = 0; l < Lanes; l++ )
+         w[ i ][ l ] += k[ i ];
+}
+
+// Runs the 64 rounds on every lane. Each step loops over the lanes so it vectorizes across messages.
+template< std::size_t Lanes, typename RoundInput >
+void compress( lane_state< Lanes >& state, RoundInput&& kw )
+{
+   uint32_t v[ 8 ][ Lanes ];
+   std::memcpy( v, state, sizeof( v ) );
+
+   for ( std::size_t i = 0; i < 64; i++ )
+   {
+      for ( std::size_t l = 0; l < Lanes; l++ )
+      {
+         uint32_t t1 = v[ 7 ][ l ] + big_sigma1( v[ 4 ][ l ] ) + ch( v[ 4 ][ l ], v[ 5 ][ l ], v[ 6 ][ l ] ) + kw( i, l );
+         uint32_t t2 = big_sigma0( v[ 0 ][ l ] ) + maj( v[ 0 ][ l ], v[ 1 ][ l ], v[ 2 ][ l ] );
+
+         v[ 7 ][ l ] = v[ 6 ][ l ];
+         v[ 6 ][ l ] = v[ 5 ][ l ];
+         v[ 5 ][ l ] = v[ 4 ][ l ];
+         v[ 4 ][ l ] = v[ 3 ][ l ] + t1;
+         v[ 3 ][ l ] = v[ 2 ][ l ];
+         v[ 2 ][ l ] = v[ 1 ][ l ];
+         v[ 1 ][ l ] = v[ 0 ][ l ];
+         v[ 0 ][ l ] = t1 + t2;
+      }
+   }
+
+   for ( std::size_t j = 0; j < 8; j++ )
+      for ( std::size_t l = 0; l < Lanes; l++ )
+         state[ j ][ l ] += v[ j ][ l ];
+}
+
+template< std::size_t Lanes >
+void store( const lane_state< Lanes >& state, char* const ( &out )[ Lanes ] )
+{
+   for ( std::size_t l = 0; l < Lanes; l++ )
+      for ( std::size_t j = 0; j < 8; j++ )
+         store_be( out[ l ] + j * 4, state[ j ][ l ] );
+}
+
+template< std::size_t Lanes >
+void hash_pairs( const char* in, char* out )
+{
+   const char* blocks[ Lanes ];
+   char* outs[ Lanes ];
+
+   for ( std::size_t l = 0; l < Lanes; l++ )
+   {
+      blocks[ l ] = in + l * block_size;
+      outs[ l ]   = out + l * digest_size;
+   }
+
+   uint32_t w[ 64 ][ Lanes ];
+   schedule( blocks, w );
+
+   lane_state< Lanes > state;
+   init( state );
+
+   compress( state, [&]( std::size_t i, std::size_t l ) { return w[ i ][ l ]; } );
+   compress( state, []( std::size_t i, std::size_t ) { return padding_schedule[ i ]; } );
+
+   store( state, outs );
+}
+
+inline std::size_t padded_blocks( std::size_t size )
+{
+   // The message is followed by a 0x80 byte and its 64 bit length
+   return ( size + 9 + block_size - 1 ) / block_size;
+}
+
+// Writes block b of the padded message
+inline void padded_block( const std::string& message, std::size_t b, char* block )
+{
+   const auto size   = message.size();
+   const auto offset = b * block_size;
+
+   std::memset( block, 0, block_size );
+
+   if ( offset < size )
+      std::memcpy( block, message.data() + offset, std::min( block_size, size - offset ) );
+
+   if ( size >= offset && size < offset + block_size )
+      block[ size - offset ] = char( 0x80 );
+
+   if ( b + 1 == padded_blocks( size ) )
+   {
+      const uint64_t bits = uint64_t( size ) * 8;
+      store_be( block + 56, uint32_t( bits >> 32 ) );
+      store_be( block + 60, uint32_t( bits ) );
+   }
+}
+
+template< std::size_t Lanes >
+void hash_messages( const std::string* const ( &messages )[ Lanes ], char* const ( &out )[ Lanes ] )
+{
+   std::size_t blocks[ Lanes ];
+   std::size_t max_blocks = 0;
+
+   for ( std::size_t l = 0; l < Lanes; l++ )
+   {
+      blocks[ l ] = padded_blocks( messages[ l ]->size() );
+      max_blocks  = std::max( max_blocks, blocks[ l ] );
+   }
+
+   char buffer[ Lanes ][ block_size ];
+   const char* block_ptrs[ Lanes ];
+   for ( std::size_t l = 0; l < Lanes; l++ )
+      block_ptrs[ l ] = buffer[ l ];
+
+   lane_state< Lanes > state;
+   init( state );
+
+   for ( std::size_t b = 0; b < max_blocks; b++ )
+   {
+      for ( std::size_t l = 0; l < Lanes; l++ )
+         padded_block( *messages[ l ], b, buffer[ l ] );
+
+      uint32_t w[ 64 ][ Lanes ];
+      schedule( block_ptrs, w );
+
+      lane_state< Lanes > prev;
+      std::memcpy( prev, state, sizeof( prev ) );
+
+      compress( state, [&]( std::size_t i, std::size_t l ) { return w[ i ][ l ]; } );
+
+      // Lanes whose message has already ended keep their digest
+      for ( std::size_t l = 0; l < Lanes; l++ )
+         if ( b >= blocks[ l ] )
+            for ( std::size_t j = 0; j < 8; j++ )
+               state[ j ][ l ] = prev[ j ][ l ];
+   }
+
+   store( state, out );
+}
+
+} // detail
+
+void hash_pairs( const char* in, char* out, std::size_t count )
+{
+   std::size_t i = 0;
+
+   for ( ; i + lanes <= count; i += lanes )
+      detail::hash_pairs< lanes >( in + i * detail::block_size, out + i * digest_size );
+
+   for ( ; i < count; i++ )
+      detail::hash_pairs< 1 >( in + i * detail::block_size, out + i * digest_size );
+}
+
+void hash_many( const std::vector< const std::string* >& messages, char* out )
+{
+   std::vector< std::size_t > order( messages.size() );
+   std::iota( order.begin(), order.end(), 0 );
+   std::stable_sort( order.begin(), order.end(), [&]( std::size_t a, std::size_t b ) { return messages[ a ]->size() < messages[ b ]->size(); } );
+
+   std::size_t i = 0;
+
+   for ( ; i + lanes <= order.size(); i += lanes )
+   {
+      const std::string* batch[ lanes ];
+      char* outs[ lanes ];
+
+      for ( std::size_t l = 0; l < lanes; l++ )
+      {
+         batch[ l ] = messages[ order[ i + l ] ];
+         outs[ l ]  = out + order[ i + l ] * digest_size;
+      }
+
+      detail::hash_messages< lanes >( batch, outs );
+   }
+
+   for ( ; i < order.size(); i++ )
+   {
+      const std::string* batch[ 1 ] = { messages[ order[ i ] ] };
+      char* outs[ 1 ] = { out + order[ i ] * digest_size };
+      detail::hash_messages< 1 >( batch, outs );
+   }
+}
+
+} // koinos::chain::sha256
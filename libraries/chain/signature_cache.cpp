@@ -0,0 +1,225 @@
+#include <koinos/chain/signature_cache.hpp>
+
+#include <koinos/crypto/multihash.hpp>
+#include <koinos/util/conversion.hpp>
+
+#include <boost/asio/post.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <future>
+#include <vector>
+
+namespace koinos::chain {
+
+std::optional< crypto::public_key > signature_cache::get( const std::string& signature, const std::string& digest ) const
+{
+   auto itr = _keys.find( std::make_pair( signature, digest ) );
+   if ( itr == _keys.end() )
+      return {};
+
+   return itr->second;
+}
+
+void signature_cache::put( const std::string& signature, const std::string& digest, const crypto::public_key& key )
+{
+   _keys.insert_or_assign( std::make_pair( signature, digest ), key );
+}
+
+std::size_t signature_cache::size() const
+{
+   return _keys.size();
+}
+
+verified_signature_cache::verified_signature_cache( std::size_t capacity ) :
+   _shard_capacity( std::max( std::size_t( 1 ), capacity / num_shards ) ) {}
+
+verified_signature_cache::shard& verified_signature_cache::get_shard( const std::string& id )
+{
+   return _shards[ std::hash< std::string >{}( id ) % num_shards ];
+}
+
+std::optional< crypto::public_key > verified_signature_cache::get( const std::string& signature, const std::string& digest )
+{
+   const auto id = signature + digest;
+   auto& s = get_shard( id );
+   std::lock_guard< std::mutex > lock( s.mutex );
+
+   auto itr = s.key_map.find( id );
+   if ( itr == s.key_map.end() )
+   {
+      _misses++;
+      return {};
+   }
+
+   s.lru_list.splice( s.lru_list.begin(), s.lru_list, itr->second );
+   _hits++;
+
+   return itr->second->key;
+}
+
+void verified_signature_cache::put( const std::string& signature, const std::string& digest, const crypto::public_key& key )
+{
+   auto id = signature + digest;
+   auto& s = get_shard( id );
+   std::lock_guard< std::mutex > lock( s.mutex );
+
+   if ( auto itr = s.key_map.find( id ); itr != s.key_map.end() )
+   {
+      s.lru_list.splice( s.lru_list.begin(), s.lru_list, itr->second );
+      return;
+   }
+
+   if ( s.lru_list.size() >= _shard_capacity )
+   {
+      s.key_map.erase( s.lru_list.back().id );
+      s.lru_list.pop_back();
+   }
+
+   s.lru_list.push_front( entry{ std::move( id ), key } );
+   s.key_map.emplace( s.lru_list.front().id, s.lru_list.begin() );
+}
+
+verified_signature_cache_stats verified_signature_cache::stats()
+{
+   verified_signature_cache_stats result;
+   result.hits   = _hits;
+   result.misses = _misses;
+
+   for ( auto& s : _shards )
+   {
+      std::lock_guard< std::mutex > lock( s.mutex );
+      result.entries += s.lru_list.size();
+   }
+
+   return result;
+}
+
+namespace detail {
+
+struct recovery_job
+{
+   const std::string*                  signature;
+   const std::string*                  digest;
+   std::optional< crypto::public_key > key;
+};
+
+std::vector< recovery_job > make_recovery_jobs( const protocol::block& block )
+{
+   std::size_t num_signatures = 1;
+   for ( const auto& trx : block.transactions() )
+      num_signatures += trx.signatures_size();
+
+   std::vector< recovery_job > jobs;
+   jobs.reserve( num_signatures );
+
+   // The block signature is verified against the block id, which apply_block asserts is the block hash
+   jobs.push_back( recovery_job { &block.signature(), &block.id() } );
+
+   for ( const auto& trx : block.transactions() )
+      for ( const auto& sig : trx.signatures() )
+         jobs.push_back( recovery_job { &sig, &trx.id() } );
+
+   return jobs;
+}
+
+// Mirrors the checks in thunk::_recover_public_key. Anything that would fail there is simply not cached.
+void recover( recovery_job& job, verified_signature_cache* verified ) noexcept
+{
+   try
+   {
+      if ( job.signature->size() != 65 )
+         return;
+
+      if ( verified )
+      {
+         if ( auto key = verified->get( *job.signature, *job.digest ) )
+         {
+            job.key = std::move( key );
+            return;
+         }
+      }
+
+      auto signature = util::converter::as< crypto::recoverable_signature >( *job.signature );
+
+      if ( !crypto::public_key::is_canonical( signature ) )
+         return;
+
+      auto pub_key = crypto::public_key::recover( signature, util::converter::to< crypto::multihash >( *job.digest ) );
+
+      if ( pub_key.valid() )
+      {
+         if ( verified )
+            verified->put( *job.signature, *job.digest, pub_key );
+
+         job.key = std::move( pub_key );
+      }
+   }
+   catch ( ... ) {}
+}
+
+std::shared_ptr< const signature_cache > make_signature_cache( const std::vector< recovery_job >& jobs )
+{
+   auto cache = std::make_shared< signature_cache >();
+
+   for ( const auto& job : jobs )
+   {
+      if ( job.key )
+         cache->put( *job.signature, *job.digest, *job.key );
+   }
+
+   return cache;
+}
+
+} // detail
+
+std::shared_ptr< const signature_cache > recover_block_signatures( const protocol::block& block, verified_signature_cache* verified )
+{
+   auto jobs = detail::make_recovery_jobs( block );
+
+   for ( auto& job : jobs )
+      detail::recover( job, verified );
+
+   return detail::make_signature_cache( jobs );
+}
+
+std::shared_ptr< const signature_cache > recover_block_signatures( const protocol::block& block, boost::asio::thread_pool& pool, std::size_t num_workers, verified_signature_cache* verified )
+{
+   auto jobs = detail::make_recovery_jobs( block );
+
+   const std::size_t num_chunks = std::min( jobs.size(), num_workers );
+
+   if ( num_chunks <= 1 )
+   {
+      for ( auto& job : jobs )
+         detail::recover( job, verified );
+
+      return detail::make_signature_cache( jobs );
+   }
+
+   const std::size_t chunk_size = ( jobs.size() + num_chunks - 1 ) / num_chunks;
+   std::vector< std::future< void > > pending;
+   pending.reserve( num_chunks );
+
+   for ( std::size_t begin = 0; begin < jobs.size(); begin += chunk_size )
+   {
+      auto end  = std::min( begin + chunk_size, jobs.size() );
+      auto done = std::make_shared< std::promise< void > >();
+      pending.emplace_back( done->get_future() );
+
+      boost::asio::post( pool, [&jobs, begin, end, done, verified]()
+      {
+         for ( auto i = begin; i < end; i++ )
+            detail::recover( jobs[ i ], verified );
+
+         done->set_value();
+      } );
+   }
+
+   for ( auto& f : pending )
+      f.wait();
+
+   return detail::make_signature_cache( jobs );
+}
+
+} // koinos::chain
@@ -104,6 +104,24 @@ void assert_permissions( execution_context& context, const object_space& space )
    }
 }
 
+bool is_cache_dependency( const object_space& space, const std::string& object_key )
+{
+   if ( !space.system() || space.zone() != zone::kernel )
+      return false;
+
+   switch ( space.id() )
+   {
+      case system_space_id::contract_bytecode:
+      case system_space_id::contract_metadata:
+      case system_space_id::system_call_dispatch:
+         return true;
+      case system_space_id::metadata:
+         return object_key == key::compute_bandwidth_registry || object_key == key::protocol_descriptor || object_key == key::block_hash_code;
+      default:
+         return false;
+   }
+}
+
 } // state
 
 } // koinos::chain
@@ -1,5 +1,7 @@
 #include <algorithm>
 #include <cassert>
+#include <cstring>
+#include <optional>
 #include <string>
 #include <stdexcept>
 
@@ -11,11 +13,14 @@
 #include <koinos/chain/execution_context.hpp>
 #include <koinos/chain/constants.hpp>
 #include <koinos/chain/host_api.hpp>
+#include <koinos/chain/merkle.hpp>
+#include <koinos/chain/parallel_executor.hpp>
 #include <koinos/chain/proto_utils.hpp>
 #include <koinos/chain/state.hpp>
 #include <koinos/chain/system_calls.hpp>
 #include <koinos/chain/thunk_dispatcher.hpp>
 #include <koinos/chain/session.hpp>
+#include <koinos/chain/sha256.hpp>
 #include <koinos/crypto/multihash.hpp>
 #include <koinos/chain/events.pb.h>
 
@@ -113,18 +118,22 @@ void register_thunks( thunk_dispatcher& td )
 // the block.
 struct block_guard
 {
-   block_guard( execution_context& context, const protocol::block& block ) :
-      ctx( context )
+   block_guard( execution_context& context, const protocol::block& block, const serialized_block& serialized ) :
+      ctx( context ),
+      prev_serialized( context.get_serialized_block() )
    {
       ctx.set_block( block );
+      ctx.set_serialized_block( &serialized );
    }
 
    ~block_guard()
    {
       ctx.clear_block();
+      ctx.set_serialized_block( prev_serialized );
    }
 
    execution_context& ctx;
+   const serialized_block* prev_serialized;
 };
 
 // RAII class to ensure apply context transaction state is consistent if there is an error applying
@@ -182,20 +191,20 @@ void validate_hash_code( crypto::multicodec id )
    }
 }
 
-std::pair< std::string, std::string > hash_compute_keys( crypto::multicodec id )
+std::pair< compute_cost, compute_cost > hash_compute_keys( crypto::multicodec id )
 {
    switch ( id )
    {
       case crypto::multicodec::sha1:
-         return { "sha1_base", "sha1_per_byte" };
+         return { compute_cost::sha1_base, compute_cost::sha1_per_byte };
       case crypto::multicodec::sha2_256:
-         return { "sha2_256_base", "sha2_256_per_byte" };
+         return { compute_cost::sha2_256_base, compute_cost::sha2_256_per_byte };
       case crypto::multicodec::sha2_512:
-         return { "sha2_512_base", "sha2_512_per_byte" };
+         return { compute_cost::sha2_512_base, compute_cost::sha2_512_per_byte };
       case crypto::multicodec::keccak_256:
-         return { "keccak_256_base", "keccak_256_per_byte" };
+         return { compute_cost::keccak_256_base, compute_cost::keccak_256_per_byte };
       case crypto::multicodec::ripemd_160:
-         return { "ripemd_160_base", "ripemd_160_per_byte" };
+         return { compute_cost::ripemd_160_base, compute_cost::ripemd_160_per_byte };
       default:
          KOINOS_THROW( unknown_hash_code_exception, "unknown hash code" );
    }
@@ -334,12 +343,18 @@ THUNK_DEFINE( void, apply_block, ((const protocol::block&) block) )
       KOINOS_ASSERT( context.get_caller_privilege() == privilege::kernel_mode, insufficient_privileges_exception, "calling privileged thunk from non-privileged code" );
       KOINOS_ASSERT( context.intent() == intent::block_application, insufficient_privileges_exception, "expected block application intent while applying block" );
 
-      block_guard guard( context, block );
+      // Blocks prepared ahead of application arrive already serialized
+      std::optional< serialized_block > local_serialized;
+      const auto* serialized = context.get_serialized_block();
+      if ( !serialized || !serialized->describes( block ) )
+         serialized = &local_serialized.emplace( serialize_block( block ) );
+
+      block_guard guard( context, block, *serialized );
 
       context.resource_meter().set_resource_limit_data( system_call::get_resource_limits( context ) );
 
       KOINOS_ASSERT(
-         system_call::hash( context, std::underlying_type_t< crypto::multicodec >( context.block_hash_code() ), util::converter::as< std::string >( block.header() ) ) == block.id(),
+         system_call::hash( context, std::underlying_type_t< crypto::multicodec >( context.block_hash_code() ), serialized->header ) == block.id(),
          malformed_block_exception,
          "block contains an invalid block id"
       );
@@ -353,29 +368,22 @@ THUNK_DEFINE( void, apply_block, ((const protocol::block&) block) )
       );
 
       // Check transaction Merkle root
-      std::vector< std::string > hashes;
-      hashes.reserve( block.transactions_size() * 2 );
+      std::vector< const std::string* > leaves;
+      leaves.reserve( block.transactions_size() * 2 );
 
-      std::size_t transactions_bytes_size = 0;
-      for ( const auto& trx : block.transactions() )
+      for ( const auto& trx : serialized->transactions )
       {
-         transactions_bytes_size += trx.ByteSizeLong();
-         hashes.emplace_back( system_call::hash( context, std::underlying_type_t< crypto::multicodec >( context.block_hash_code() ), util::converter::as< std::string >( trx.header() ) ) );
-         std::stringstream ss;
-
-         for ( const auto& sig : trx.signatures() )
-         {
-            ss << sig;
-         }
-
-         hashes.emplace_back( system_call::hash( context, std::underlying_type_t< crypto::multicodec >( context.block_hash_code() ), ss.str() ) );
+         leaves.push_back( &trx.header );
+         leaves.push_back( &trx.signatures );
       }
 
-      context.resource_meter().use_network_bandwidth( block.ByteSizeLong() - transactions_bytes_size );
+      auto hashes = hash_batch( context, std::underlying_type_t< crypto::multicodec >( context.block_hash_code() ), leaves );
+
+      context.resource_meter().use_network_bandwidth( serialized->block.size() - serialized->transactions_size );
 
       KOINOS_ASSERT( system_call::verify_merkle_root( context, block.header().transaction_merkle_root(), hashes ), malformed_block_exception, "transaction merkle root does not match" );
 
-      auto block_hash = util::converter::to< crypto::multihash >( system_call::hash( context, std::underlying_type_t< crypto::multicodec >( context.block_hash_code() ), util::converter::as< std::string >( block.header() ) ) );
+      auto block_hash = util::converter::to< crypto::multihash >( system_call::hash( context, std::underlying_type_t< crypto::multicodec >( context.block_hash_code() ), serialized->header ) );
       KOINOS_ASSERT(
          system_call::process_block_signature(
             context,
@@ -390,17 +398,23 @@ THUNK_DEFINE( void, apply_block, ((const protocol::block&) block) )
       system_call::pre_block_callback( context );
 
       // We directly call put_object on the state node so that we do not charge disk_storage for the storage of the new head block
-      const auto serialized_block = util::converter::as< std::string >( block );
-      context.get_state_node()->put_object( state::space::metadata(), state::key::head_block, &serialized_block );
+      context.get_state_node()->put_object( state::space::metadata(), state::key::head_block, &serialized->block );
 
-      for ( const auto& tx : block.transactions() )
+      if ( auto* executor = context.parallel_executor(); executor && block.transactions_size() > 1 )
       {
-         try
+         executor->apply_transactions( context, block );
+      }
+      else
+      {
+         for ( const auto& tx : block.transactions() )
          {
-            system_call::apply_transaction( context, tx );
+            try
+            {
+               system_call::apply_transaction( context, tx );
+            }
+            catch ( const reversion_exception& ) {} /* do nothing */
+            KOINOS_CAPTURE_CATCH_AND_RETHROW( ("transaction_id", util::to_hex( tx.id() )) )
          }
-         catch ( const reversion_exception& ) {} /* do nothing */
-         KOINOS_CAPTURE_CATCH_AND_RETHROW( ("transaction_id", util::to_hex( tx.id() )) )
       }
 
       system_call::post_block_callback( context );
@@ -478,6 +492,11 @@ THUNK_DEFINE( void, apply_transaction, ((const protocol::transaction&) trx) )
 
       transaction_guard guard( context, trx );
 
+      std::optional< serialized_transaction > local_serialized;
+      const auto* serialized = context.get_serialized_transaction( trx );
+      if ( !serialized )
+         serialized = &local_serialized.emplace( serialize_transaction( trx ) );
+
       const auto& payer = trx.header().payer();
       const auto& payee = trx.header().payee();
 
@@ -505,7 +524,7 @@ THUNK_DEFINE( void, apply_transaction, ((const protocol::transaction&) trx) )
          KOINOS_ASSERT( trx.header().chain_id() == chain_id.value(), failure_exception, "chain id mismatch" );
 
          KOINOS_ASSERT(
-            system_call::hash( context, std::underlying_type_t< crypto::multicodec >( context.block_hash_code() ), util::converter::as< std::string >( trx.header() ) ) == trx.id(),
+            system_call::hash( context, std::underlying_type_t< crypto::multicodec >( context.block_hash_code() ), serialized->header ) == trx.id(),
             failure_exception,
             "transaction contains an invalid transaction id"
          );
@@ -519,11 +538,13 @@ THUNK_DEFINE( void, apply_transaction, ((const protocol::transaction&) trx) )
          );
 
          // Check operation merkle root
-         std::vector< std::string > hashes;
-         hashes.reserve( trx.operations_size() );
+         std::vector< const std::string* > leaves;
+         leaves.reserve( serialized->operations.size() );
+
+         for ( const auto& op : serialized->operations )
+            leaves.push_back( &op );
 
-         for ( const auto& op : trx.operations() )
-            hashes.emplace_back( system_call::hash( context, std::underlying_type_t< crypto::multicodec >( context.block_hash_code() ), util::converter::as< std::string >( op ) ) );
+         auto hashes = hash_batch( context, std::underlying_type_t< crypto::multicodec >( context.block_hash_code() ), leaves );
 
          KOINOS_ASSERT( system_call::verify_merkle_root( context, trx.header().operation_merkle_root(), hashes ), failure_exception, "operation merkle root does not match" );
 
@@ -566,14 +587,15 @@ THUNK_DEFINE( void, apply_transaction, ((const protocol::transaction&) trx) )
       // because those calls might write to database and those writes must persist regardless of whether
       // the rest of the transaction is reverted or not.
       auto block_node = context.get_state_node();
+      auto parent_node = context.get_parent_node();
       auto trx_node = block_node->create_anonymous_node();
-      context.set_state_node( trx_node, block_node->parent() );
+      context.set_state_node( trx_node, parent_node );
 
       try
       {
          system_call::pre_transaction_callback( context );
 
-         context.resource_meter().use_network_bandwidth( trx.ByteSizeLong() );
+         context.resource_meter().use_network_bandwidth( serialized->size );
 
          for ( const auto& o : trx.operations() )
          {
@@ -622,7 +644,7 @@ THUNK_DEFINE( void, apply_transaction, ((const protocol::transaction&) trx) )
       // BEGIN: No throw section
       // Throwing will result in lost events and logs on transaction receipts.
 
-      context.set_state_node( block_node );
+      context.set_state_node( block_node, parent_node );
 
       used_rc = payer_session->used_rc();
       logs = payer_session->logs();
@@ -1022,7 +1044,7 @@ THUNK_DEFINE( consume_block_resources_result, consume_block_resources, ((uint64_
 THUNK_DEFINE( void, put_object, ((const object_space&) space, (const std::string&) key, (const std::string&) obj) )
 {
    KOINOS_ASSERT( !context.read_only(), read_only_context_exception, "cannot put object during read only call" );
-   context.resource_meter().use_compute_bandwidth( context.get_compute_bandwidth( "object_serialization_per_byte" ) * obj.size() );
+   context.resource_meter().use_compute_bandwidth( context.get_compute_bandwidth( compute_cost::object_serialization_per_byte ) * obj.size() );
 
    state::assert_permissions( context, space );
 
@@ -1031,6 +1053,12 @@ THUNK_DEFINE( void, put_object, ((const object_space&) space, (const std::string
    auto val = util::converter::as< state_db::object_value >( obj );
 
    context.resource_meter().use_disk_storage( state->put_object( space, key, &val ) );
+
+   if ( auto* access = context.state_access() )
+      access->record_write( space, key );
+
+   if ( state::is_cache_dependency( space, key ) )
+      context.mark_cache_stale();
 }
 
 THUNK_DEFINE( void, remove_object, ((const object_space&) space, (const std::string&) key) )
@@ -1043,6 +1071,12 @@ THUNK_DEFINE( void, remove_object, ((const object_space&) space, (const std::str
    KOINOS_ASSERT( state, internal_error_exception, "current state node does not exist" );
 
    context.resource_meter().use_disk_storage( state->remove_object( space, key ) );
+
+   if ( auto* access = context.state_access() )
+      access->record_write( space, key );
+
+   if ( state::is_cache_dependency( space, key ) )
+      context.mark_cache_stale();
 }
 
 THUNK_DEFINE( get_object_result, get_object, ((const object_space&) space, (const std::string&) key) )
@@ -1055,11 +1089,14 @@ THUNK_DEFINE( get_object_result, get_object, ((const object_space&) space, (cons
 
    const auto result = state->get_object( space, key );
 
+   if ( auto* access = context.state_access() )
+      access->record_read( space, key );
+
    get_object_result ret;
 
    if( result )
    {
-      context.resource_meter().use_compute_bandwidth( context.get_compute_bandwidth( "object_serialization_per_byte" ) * result->size() );
+      context.resource_meter().use_compute_bandwidth( context.get_compute_bandwidth( compute_cost::object_serialization_per_byte ) * result->size() );
       ret.mutable_value()->set_exists( true );
       ret.mutable_value()->set_value( result->data(), result->size() );
    }
@@ -1076,11 +1113,14 @@ THUNK_DEFINE( get_next_object_result, get_next_object, ((const object_space&) sp
 
    const auto [result, next_key] = state->get_next_object( space, key );
 
+   if ( auto* access = context.state_access() )
+      access->record_range_read( space );
+
    get_next_object_result ret;
 
    if( result )
    {
-      context.resource_meter().use_compute_bandwidth( context.get_compute_bandwidth( "object_serialization_per_byte" ) * result->size() );
+      context.resource_meter().use_compute_bandwidth( context.get_compute_bandwidth( compute_cost::object_serialization_per_byte ) * result->size() );
       ret.mutable_value()->set_exists( true );
       ret.mutable_value()->set_value( result->data(), result->size() );
       ret.mutable_value()->set_key( next_key );
@@ -1098,11 +1138,14 @@ THUNK_DEFINE( get_prev_object_result, get_prev_object, ((const object_space&) sp
 
    const auto [result, next_key] = state->get_prev_object( space, key );
 
+   if ( auto* access = context.state_access() )
+      access->record_range_read( space );
+
    get_prev_object_result ret;
 
    if( result )
    {
-      context.resource_meter().use_compute_bandwidth( context.get_compute_bandwidth( "object_serialization_per_byte" ) * result->size() );
+      context.resource_meter().use_compute_bandwidth( context.get_compute_bandwidth( compute_cost::object_serialization_per_byte ) * result->size() );
       ret.mutable_value()->set_exists( true );
       ret.mutable_value()->set_value( result->data(), result->size() );
       ret.mutable_value()->set_key( next_key );
@@ -1127,7 +1170,7 @@ THUNK_DEFINE( void, event, ((const std::string&) name, (const std::string&) data
    KOINOS_ASSERT( name.size() <= 128, reversion_exception, "event name cannot be larger than 128 bytes" );
    KOINOS_ASSERT( validate_utf( name ), reversion_exception, "event name contains invalid utf-8" );
 
-   context.resource_meter().use_compute_bandwidth( context.get_compute_bandwidth( "event_per_impacted" ) * impacted.size() );
+   context.resource_meter().use_compute_bandwidth( context.get_compute_bandwidth( compute_cost::event_per_impacted ) * impacted.size() );
 
    const auto& caller = context.get_caller();
 
@@ -1165,6 +1208,79 @@ THUNK_DEFINE( hash_result, hash, ((uint64_t) id, (const std::string&) obj, (uint
    return ret;
 }
 
+std::vector< std::string > hash_batch( execution_context& context, uint64_t code, const std::vector< const std::string* >& inputs )
+{
+   std::vector< std::string > hashes;
+   hashes.reserve( inputs.size() );
+
+   if ( inputs.empty() )
+      return hashes;
+
+   const auto sid = static_cast< uint32_t >( system_call_id::hash );
+   const auto& target = context.resolve_system_call( sid );
+   const auto* thunk_bundle = std::get_if< thunk_cache_bundle >( &target );
+
+   if ( !thunk_bundle || thunk_bundle->is_override )
+   {
+      for ( const auto* input : inputs )
+         hashes.emplace_back( system_call::hash( context, code, *input ) );
+
+      return hashes;
+   }
+
+   with_stack_frame(
+      context,
+      stack_frame {
+         .sid = sid,
+         .call_privilege = privilege::kernel_mode
+      },
+      [&]() {
+         auto multicodec = static_cast< crypto::multicodec >( code );
+         const auto thunk_compute = context.get_thunk_compute_bandwidth( context.thunk_translation( sid, *thunk_bundle ) );
+         uint64_t hash_base = 0, hash_per_byte = 0;
+
+         // Every input is charged before any is hashed, a meter that runs out stops at the same input
+         for ( std::size_t i = 0; i < inputs.size(); i++ )
+         {
+            context.resource_meter().use_compute_bandwidth( thunk_compute );
+
+            if ( i == 0 )
+            {
+               validate_hash_code( multicodec );
+               auto [ base_key, per_byte_key ] = hash_compute_keys( multicodec );
+               hash_base     = context.get_compute_bandwidth( base_key );
+               hash_per_byte = context.get_compute_bandwidth( per_byte_key );
+            }
+
+            context.resource_meter().use_compute_bandwidth( hash_base + hash_per_byte * inputs[ i ]->size() );
+         }
+
+         if ( multicodec != crypto::multicodec::sha2_256 )
+         {
+            for ( const auto* input : inputs )
+               hashes.emplace_back( util::converter::as< std::string >( crypto::hash( multicodec, *input ) ) );
+
+            return;
+         }
+
+         std::string digests( inputs.size() * sha256::digest_size, '\0' );
+         sha256::hash_many( inputs, digests.data() );
+
+         // The multihash prefix is the same for every sha256 digest
+         auto prefix = util::converter::as< std::string >( crypto::hash( multicodec, std::string() ) );
+         prefix.resize( prefix.size() - sha256::digest_size );
+
+         for ( std::size_t i = 0; i < inputs.size(); i++ )
+         {
+            auto& hash = hashes.emplace_back( prefix );
+            hash.append( digests, i * sha256::digest_size, sha256::digest_size );
+         }
+      }
+   );
+
+   return hashes;
+}
+
 THUNK_DEFINE( recover_public_key_result, recover_public_key, ((dsa) type, (const std::string&) signature_data, (const std::string&) digest, (bool) compressed) )
 {
    KOINOS_ASSERT( type == ecdsa_secp256k1, unknown_dsa_exception, "unexpected dsa" );
@@ -1174,9 +1290,16 @@ THUNK_DEFINE( recover_public_key_result, recover_public_key, ((dsa) type, (const
 
    KOINOS_ASSERT( crypto::public_key::is_canonical( signature ), invalid_signature_exception, "signature must be canonical" );
 
-   auto pub_key = crypto::public_key::recover( signature, util::converter::to< crypto::multihash >( digest ) );
+   std::optional< crypto::public_key > cached_key;
+   if ( auto cache = context.signature_cache() )
+      cached_key = cache->get( signature_data, digest );
+
+   auto pub_key = cached_key ? *cached_key : crypto::public_key::recover( signature, util::converter::to< crypto::multihash >( digest ) );
    KOINOS_ASSERT( pub_key.valid(), invalid_signature_exception, "public key is invalid" );
 
+   if ( auto verified = context.verified_signatures(); verified && !cached_key )
+      verified->put( signature_data, digest, pub_key );
+
    recover_public_key_result ret;
    if ( compressed )
       ret.set_value( util::converter::as< std::string >( pub_key ) );
@@ -1188,8 +1311,8 @@ THUNK_DEFINE( recover_public_key_result, recover_public_key, ((dsa) type, (const
 
 THUNK_DEFINE( verify_merkle_root_result, verify_merkle_root, ((const std::string&) root, (const std::vector< std::string >&) hashes) )
 {
-   uint64_t deserialize_multihash_base = context.get_compute_bandwidth( "deserialize_multihash_base" );
-   uint64_t deserialize_multihash_per_byte = context.get_compute_bandwidth( "deserialize_multihash_per_byte" );
+   uint64_t deserialize_multihash_base = context.get_compute_bandwidth( compute_cost::deserialize_multihash_base );
+   uint64_t deserialize_multihash_per_byte = context.get_compute_bandwidth( compute_cost::deserialize_multihash_per_byte );
 
    // Charge for all deserialization
    context.resource_meter().use_compute_bandwidth( ( hashes.size() + 1 ) * ( deserialize_multihash_base + root.size() * deserialize_multihash_per_byte ) );
@@ -1204,6 +1327,37 @@ THUNK_DEFINE( verify_merkle_root_result, verify_merkle_root, ((const std::string
 
    validate_hash_code( root_hash.code() );
 
+   verify_merkle_root_result ret;
+
+   // SHA-256 trees are reduced in place over a contiguous digest buffer
+   if ( root_hash.code() == crypto::multicodec::sha2_256 && root_hash.digest().size() == sha256::digest_size && hashes.size() )
+   {
+      // Leaves that serialize exactly like the root apart from the digest are copied without parsing
+      const auto canonical_root = util::converter::as< std::string >( root_hash );
+      const auto prefix_size = canonical_root.size() - sha256::digest_size;
+
+      std::string digests;
+      digests.reserve( hashes.size() * sha256::digest_size );
+
+      for ( const auto& s : hashes )
+      {
+         if ( s.size() == canonical_root.size() && s.compare( 0, prefix_size, canonical_root, 0, prefix_size ) == 0 )
+         {
+            digests.append( s, prefix_size, sha256::digest_size );
+            continue;
+         }
+
+         auto mh = util::converter::to< crypto::multihash >( s );
+         KOINOS_ASSERT( mh.code() == root_hash.code(), unknown_hash_code_exception, "leaf and merkle root hash codes do not match" );
+         KOINOS_ASSERT( mh.digest().size() == root_hash.digest().size(), unknown_hash_code_exception, "leaf and merkle root hash sizes do not match" );
+         digests.append( reinterpret_cast< const char* >( mh.digest().data() ), mh.digest().size() );
+      }
+
+      auto merkle_root = merkle::sha256_merkle_root( digests );
+      ret.set_value( std::memcmp( merkle_root.data(), root_hash.digest().data(), sha256::digest_size ) == 0 );
+      return ret;
+   }
+
    std::vector< crypto::multihash > leaves;
 
    leaves.resize( hashes.size() );
@@ -1220,7 +1374,6 @@ THUNK_DEFINE( verify_merkle_root_result, verify_merkle_root, ((const std::string
 
    auto merkle_root = mtree.root()->hash();
 
-   verify_merkle_root_result ret;
    ret.set_value( merkle_root == root_hash );
    return ret;
 }
@@ -1271,24 +1424,20 @@ THUNK_DEFINE( call_result, call, ((const std::string&) contract_id, (uint32_t) e
    // authorize should only be called from kernel mode
    KOINOS_ASSERT( entry_point != authorize_entrypoint || context.get_caller_privilege() == privilege::kernel_mode, insufficient_privileges_exception, "calling privileged thunk from non-privileged code" );
 
-   try
-   {
-      with_stack_frame(
-         context,
-         stack_frame {
-            .contract_id = contract_id,
-            .call_privilege = contract_meta.system() ? privilege::kernel_mode : privilege::user_mode,
-            .call_args = args,
-            .entry_point = entry_point
-         },
-         [&]
-         {
-            chain::host_api hapi( context );
-            context.get_backend()->run( hapi, contract_object.value(), contract_meta.hash() );
-         }
-      );
-   }
-   catch ( const success_exception& ) {}
+   with_stack_frame(
+      context,
+      stack_frame {
+         .contract_id = contract_id,
+         .call_privilege = contract_meta.system() ? privilege::kernel_mode : privilege::user_mode,
+         .call_args = args,
+         .entry_point = entry_point
+      },
+      [&]
+      {
+         chain::host_api hapi( context );
+         context.get_backend()->run( hapi, contract_object.value(), contract_meta.hash() );
+      }
+   );
 
    const auto& res = context.get_result();
 
@@ -1313,9 +1462,10 @@ THUNK_DEFINE( void, exit, ((int32_t) code, (result) res) )
 {
    context.set_result( { code, res } );
 
+   // A successful exit returns, the host api halts the contract and native callers unwind in system_call::exit
    if ( !code ) // code == success
    {
-      throw success_exception( code );
+      return;
    }
 
    KOINOS_ASSERT( res.has_error(), reversion_exception, "exit error did not contain error data" );
@@ -15,19 +15,36 @@ const thunk_dispatcher& thunk_dispatcher::instance()
 
 void thunk_dispatcher::call_thunk( uint32_t id, execution_context& ctx, char* ret_ptr, uint32_t ret_len, const char* arg_ptr, uint32_t arg_len, uint32_t* bytes_written )const
 {
-   auto it = _dispatch_map.find( id );
-   KOINOS_ASSERT( it != _dispatch_map.end(), unknown_thunk_exception, "thunk ${id} not found", ("id", id) );
-   it->second( ctx, ret_ptr, ret_len, arg_ptr, arg_len, bytes_written );
+   const auto* entry = get_entry( id );
+   KOINOS_ASSERT( entry, unknown_thunk_exception, "thunk ${id} not found", ("id", id) );
+   entry->handler( ctx, ret_ptr, ret_len, arg_ptr, arg_len, bytes_written );
 }
 
 bool thunk_dispatcher::thunk_exists( uint32_t id ) const
 {
-   return _dispatch_map.count( id );
+   return get_entry( id ) != nullptr;
 }
 
 bool thunk_dispatcher::thunk_is_genesis( uint32_t id ) const
 {
-   return _genesis_thunks.count( id );
+   const auto* entry = get_entry( id );
+   return entry && entry->genesis;
+}
+
+const thunk_dispatcher::thunk_entry* thunk_dispatcher::get_entry( uint32_t id ) const
+{
+   if ( id >= _thunks.size() || !_thunks[ id ].handler )
+      return nullptr;
+
+   return &_thunks[ id ];
+}
+
+thunk_dispatcher::thunk_entry& thunk_dispatcher::get_or_create_entry( uint32_t id )
+{
+   if ( id >= _thunks.size() )
+      _thunks.resize( id + 1 );
+
+   return _thunks[ id ];
 }
 
 } // koinos::chain
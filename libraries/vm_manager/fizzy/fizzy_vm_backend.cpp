@@ -2,20 +2,26 @@
 #include <fizzy/fizzy.h>
 
 #include <koinos/exception.hpp>
+#include <koinos/log.hpp>
+#include <koinos/util/hex.hpp>
 
 #include <koinos/vm_manager/fizzy/exceptions.hpp>
 #include <koinos/vm_manager/fizzy/fizzy_vm_backend.hpp>
 
 #include <exception>
+#include <memory>
 #include <optional>
 #include <string>
+#include <utility>
+#include <vector>
 #include <iostream>
 
 namespace koinos::vm_manager::fizzy {
 
 namespace constants {
    constexpr uint32_t    fizzy_max_call_depth = 251;
-   constexpr std::size_t module_cache_size    = 32;
+   constexpr std::size_t instance_pool_size   = 4;
+   constexpr uint32_t    memory_pages_limit   = 512; // Number of 64k pages allowed to allocate
 }
 
 /**
@@ -46,9 +52,20 @@ char* resolve_ptr( FizzyInstance* fizzy_instance, uint32_t ptr, uint32_t size )
    return mem_data + ptr;
 }
 
-fizzy_vm_backend::fizzy_vm_backend() :
-   _cache( constants::module_cache_size ) {}
-fizzy_vm_backend::~fizzy_vm_backend() {}
+fizzy_vm_backend::fizzy_vm_backend( std::size_t module_cache_size ) :
+   _cache_size( module_cache_size ),
+   _cache( module_cache_size ) {}
+
+fizzy_vm_backend::~fizzy_vm_backend()
+{
+   _stopped = true;
+   if ( _preload_thread.joinable() )
+      _preload_thread.join();
+
+   auto stats = _cache.stats();
+   LOG(info) << "Module cache: " << stats.hits << " hits, " << stats.misses << " misses, " << stats.evictions << " evictions, "
+             << stats.rejected << " rejected, " << stats.modules << " modules (" << stats.bytes << " bytes) cached";
+}
 
 std::string fizzy_vm_backend::backend_name()
 {
@@ -89,28 +106,29 @@ class fizzy_runner
       void instantiate_module();
       void call_start();
 
+      FizzyInstance* instantiate( pooled_instance* handle );
+
       FizzyExecutionResult _invoke_thunk( const FizzyValue* args, FizzyExecutionContext* fizzy_context ) noexcept;
       FizzyExecutionResult _invoke_system_call( const FizzyValue* args, FizzyExecutionContext* fizzy_context ) noexcept;
 
    private:
-      abstract_host_api&     _hapi;
-      module_ptr             _module = nullptr;
-      FizzyInstance*         _instance = nullptr;
-      FizzyExecutionContext* _fizzy_context = nullptr;
-      int64_t                _previous_ticks;
-      std::exception_ptr     _exception;
+      abstract_host_api&                 _hapi;
+      module_ptr                         _module = nullptr;
+      std::unique_ptr< pooled_instance > _handle;
+      FizzyInstance*                     _instance = nullptr;
+      FizzyExecutionContext*             _fizzy_context = nullptr;
+      int64_t                            _previous_ticks;
+      std::exception_ptr                 _exception;
 };
 
 fizzy_runner::~fizzy_runner()
 {
-   if ( _instance != nullptr )
-      fizzy_free_instance( _instance );
-
-   if ( _fizzy_context != nullptr )
-      fizzy_free_execution_context( _fizzy_context );
+   // Unpooled instances are freed by the handle
+   if ( auto pool = _module->pool(); pool != nullptr && _handle )
+      pool->release( std::move( _handle ) );
 }
 
-module_ptr parse_bytecode( const char* bytecode_data, size_t bytecode_size )
+const FizzyModule* parse_module( const char* bytecode_data, size_t bytecode_size )
 {
    FizzyError fizzy_err;
    KOINOS_ASSERT( bytecode_data != nullptr, fizzy_returned_null_exception, "fizzy_instance was unexpectedly null pointer" );
@@ -123,46 +141,114 @@ module_ptr parse_bytecode( const char* bytecode_data, size_t bytecode_size )
       KOINOS_THROW( module_parse_exception, "could not parse fizzy module - ${code}: ${msg}", ("code", error_code)("msg", error_message) );
    }
 
-   return std::make_shared< const module_guard >( ptr );
+   return ptr;
+}
+
+module_ptr parse_bytecode( const char* bytecode_data, size_t bytecode_size )
+{
+   return std::make_shared< const module_guard >( parse_module( bytecode_data, bytecode_size ) );
+}
+
+/**
+ * Parse a module whose instances are reused through an instance_pool.
+ *
+ * Resetting an instance requires access to every mutable global. The C API only reaches globals
+ * through exports, so they are exported under reserved names first. Modules that cannot be
+ * rewritten that way are returned without a pool and instantiated on every run.
+ */
+module_ptr parse_pooled_bytecode( const std::string& bytecode )
+{
+   const FizzyModule* module = parse_module( bytecode.data(), bytecode.size() );
+
+   std::vector< std::pair< uint32_t, std::string > > globals;
+   for ( uint32_t i = 0; i < fizzy_get_global_count( module ); i++ )
+   {
+      if ( fizzy_get_global_type( module, i ).is_mutable )
+         globals.emplace_back( i, "__koinos_global_" + std::to_string( i ) );
+   }
+
+   if ( globals.size() )
+   {
+      auto rewritten = export_globals( bytecode, globals );
+      if ( !rewritten )
+         return std::make_shared< const module_guard >( module );
+
+      FizzyError fizzy_err;
+      auto pooled_module = fizzy_parse( reinterpret_cast< const uint8_t* >( rewritten->data() ), rewritten->size(), &fizzy_err );
+      if ( pooled_module == nullptr )
+         return std::make_shared< const module_guard >( module );
+
+      fizzy_free_module( module );
+      module = pooled_module;
+   }
+
+   std::vector< std::string > names;
+   names.reserve( globals.size() );
+   for ( auto& [ index, name ] : globals )
+      names.emplace_back( std::move( name ) );
+
+   return std::make_shared< const module_guard >( module, std::make_unique< instance_pool >( std::move( names ), constants::instance_pool_size ) );
 }
 
 void fizzy_runner::instantiate_module()
+{
+   KOINOS_ASSERT( !_handle, runner_state_exception, "_instance was unexpectedly non-null" );
+
+   if ( auto pool = _module->pool(); pool != nullptr )
+      _handle = pool->acquire();
+
+   if ( !_handle )
+   {
+      // A start section may call into the host during instantiation, so the runner is bound first
+      _handle = std::make_unique< pooled_instance >();
+      _handle->runner = this;
+      _handle->instance = instantiate( _handle.get() );
+
+      if ( auto pool = _module->pool(); pool != nullptr )
+         pool->prepare( *_handle );
+   }
+
+   _handle->runner = this;
+   _instance = _handle->instance;
+   _fizzy_context = _handle->context;
+}
+
+FizzyInstance* fizzy_runner::instantiate( pooled_instance* handle )
 {
    FizzyExternalFn invoke_thunk = [](void* voidptr_context, FizzyInstance* fizzy_instance, const FizzyValue* args, FizzyExecutionContext* fizzy_context) noexcept -> FizzyExecutionResult
    {
-      fizzy_runner* runner = static_cast< fizzy_runner* >( voidptr_context );
+      fizzy_runner* runner = static_cast< fizzy_runner* >( static_cast< pooled_instance* >( voidptr_context )->runner );
       return runner->_invoke_thunk( args, fizzy_context );
    };
 
    FizzyValueType invoke_thunk_arg_types[] = {FizzyValueTypeI32, FizzyValueTypeI32, FizzyValueTypeI32, FizzyValueTypeI32, FizzyValueTypeI32, FizzyValueTypeI32};
    size_t invoke_thunk_num_args = 6;
-   FizzyExternalFunction invoke_thunk_fn = {{ FizzyValueTypeI32, invoke_thunk_arg_types, invoke_thunk_num_args }, invoke_thunk, this };
+   FizzyExternalFunction invoke_thunk_fn = {{ FizzyValueTypeI32, invoke_thunk_arg_types, invoke_thunk_num_args }, invoke_thunk, handle };
 
    FizzyExternalFn invoke_system_call = [](void* voidptr_context, FizzyInstance* fizzy_instance, const FizzyValue* args, FizzyExecutionContext* fizzy_context) noexcept -> FizzyExecutionResult
    {
-      fizzy_runner* runner = static_cast< fizzy_runner* >( voidptr_context );
+      fizzy_runner* runner = static_cast< fizzy_runner* >( static_cast< pooled_instance* >( voidptr_context )->runner );
       return runner->_invoke_system_call( args, fizzy_context );
    };
 
    FizzyValueType invoke_system_call_arg_types[] = {FizzyValueTypeI32, FizzyValueTypeI32, FizzyValueTypeI32, FizzyValueTypeI32, FizzyValueTypeI32, FizzyValueTypeI32};
    size_t invoke_system_call_num_args = 6;
-   FizzyExternalFunction invoke_system_call_fn = {{ FizzyValueTypeI32, invoke_system_call_arg_types, invoke_system_call_num_args }, invoke_system_call, this };
+   FizzyExternalFunction invoke_system_call_fn = {{ FizzyValueTypeI32, invoke_system_call_arg_types, invoke_system_call_num_args }, invoke_system_call, handle };
 
    size_t num_host_funcs = 2;
    FizzyImportedFunction host_funcs[] = {{"env", "invoke_thunk", invoke_thunk_fn}, {"env", "invoke_system_call", invoke_system_call_fn}};
 
    FizzyError fizzy_err;
 
-   uint32_t memory_pages_limit = 512;     // Number of 64k pages allowed to allocate
-
-   KOINOS_ASSERT( _instance == nullptr, runner_state_exception, "_instance was unexpectedly non-null" );
-   _instance = fizzy_resolve_instantiate( _module->get(), host_funcs, num_host_funcs, nullptr, nullptr, nullptr, 0, memory_pages_limit, &fizzy_err );
-   if( _instance == nullptr )
+   auto instance = fizzy_resolve_instantiate( _module->get(), host_funcs, num_host_funcs, nullptr, nullptr, nullptr, 0, constants::memory_pages_limit, &fizzy_err );
+   if( instance == nullptr )
    {
       std::string error_code = fizzy_error_code_name( fizzy_err.code );
       std::string error_message = fizzy_err.message;
       KOINOS_THROW( module_instantiate_exception, "could not instantiate module - ${code}: ${msg}", ("code", error_code)("msg", error_message) );
    }
+
+   return instance;
 }
 
 FizzyExecutionResult fizzy_runner::_invoke_thunk( const FizzyValue* args, FizzyExecutionContext* fizzy_context ) noexcept
@@ -208,7 +294,8 @@ FizzyExecutionResult fizzy_runner::_invoke_thunk( const FizzyValue* args, FizzyE
       _exception = std::current_exception();
    }
 
-   result.trapped = !!_exception;
+   // A successful exit halts execution the same way as a trap, but without an exception
+   result.trapped = !!_exception || _hapi.exited();
    return result;
 }
 
@@ -255,16 +342,29 @@ FizzyExecutionResult fizzy_runner::_invoke_system_call( const FizzyValue* args,
       _exception = std::current_exception();
    }
 
-   result.trapped = !!_exception;
+   // A successful exit halts execution the same way as a trap, but without an exception
+   result.trapped = !!_exception || _hapi.exited();
    return result;
 }
 
 void fizzy_runner::call_start()
 {
-   KOINOS_ASSERT( _fizzy_context == nullptr, runner_state_exception, "_fizzy_context was unexpectedly non-null" );
+   KOINOS_ASSERT( _handle, runner_state_exception, "_instance was unexpectedly null" );
    _previous_ticks = _hapi.get_meter_ticks();
-   _fizzy_context = fizzy_create_metered_execution_context( constants::fizzy_max_call_depth, _previous_ticks );
-   KOINOS_ASSERT( _fizzy_context != nullptr, create_context_exception, "could not create execution context" );
+
+   // Pooled execution contexts are recycled, only their tick budget needs to be reset
+   if ( _fizzy_context == nullptr )
+   {
+      _fizzy_context = fizzy_create_metered_execution_context( constants::fizzy_max_call_depth, _previous_ticks );
+      KOINOS_ASSERT( _fizzy_context != nullptr, create_context_exception, "could not create execution context" );
+      _handle->context = _fizzy_context;
+   }
+   else
+   {
+      int64_t* ticks = fizzy_get_execution_context_ticks( _fizzy_context );
+      KOINOS_ASSERT( ticks != nullptr, fizzy_returned_null_exception, "fizzy_get_execution_context_ticks() unexpectedly returned null pointer" );
+      *ticks = _previous_ticks;
+   }
 
    uint32_t start_func_idx = 0;
    bool success = fizzy_find_exported_function_index( _module->get(), "_start", &start_func_idx );
@@ -283,12 +383,60 @@ void fizzy_runner::call_start()
       std::rethrow_exception( exc );
    }
 
-   if ( result.trapped )
+   if ( result.trapped && !_hapi.exited() )
    {
       KOINOS_THROW( wasm_trap_exception, "module exited due to trap" );
    }
 }
 
+void fizzy_vm_backend::set_module_directory( const std::filesystem::path& dir )
+{
+   KOINOS_ASSERT( !_store, runner_state_exception, "module directory was already set" );
+   _store = std::make_unique< module_store >( dir );
+   _preload_thread = std::thread( [this]() { preload_modules(); } );
+}
+
+void fizzy_vm_backend::preload_modules()
+{
+   std::size_t num_modules = 0;
+   std::size_t bytes = 0;
+
+   // Most recently stored modules first, until the cache is full
+   for ( const auto& id : _store->ids() )
+   {
+      if ( _stopped )
+         break;
+
+      if ( _cache.contains( id ) )
+         continue;
+
+      auto bytecode = _store->get( id );
+      if ( !bytecode )
+         continue;
+
+      bytes += bytecode->size();
+      if ( bytes > _cache_size )
+         break;
+
+      try
+      {
+         _cache.put_module( id, parse_pooled_bytecode( *bytecode ), bytecode->size() );
+         num_modules++;
+      }
+      catch ( const std::exception& e )
+      {
+         LOG(warning) << "Could not preload module " << util::to_hex( id ) << ": " << e.what();
+      }
+   }
+
+   LOG(info) << "Preloaded " << num_modules << " modules (" << bytes << " bytes)";
+}
+
+module_cache_stats fizzy_vm_backend::cache_stats()
+{
+   return _cache.stats();
+}
+
 void fizzy_vm_backend::run( abstract_host_api& hapi, const std::string& bytecode, const std::string& id )
 {
    module_ptr ptr;
@@ -298,8 +446,20 @@ void fizzy_vm_backend::run( abstract_host_api& hapi, const std::string& bytecode
       ptr = _cache.get_module( id );
       if ( !ptr )
       {
-         ptr = parse_bytecode( bytecode.data(), bytecode.size() );
-         _cache.put_module( id, ptr );
+         ptr = parse_pooled_bytecode( bytecode );
+         _cache.put_module( id, ptr, bytecode.size() );
+
+         if ( _store && !_store->contains( id ) )
+         {
+            try
+            {
+               _store->put( id, bytecode );
+            }
+            catch ( const std::exception& e )
+            {
+               LOG(warning) << "Could not store module " << util::to_hex( id ) << ": " << e.what();
+            }
+         }
       }
    }
    else
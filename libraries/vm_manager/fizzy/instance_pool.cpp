@@ -0,0 +1,250 @@
+#include <koinos/vm_manager/fizzy/instance_pool.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+namespace koinos::vm_manager::fizzy {
+
+pooled_instance::~pooled_instance()
+{
+   if ( instance != nullptr )
+      fizzy_free_instance( instance );
+
+   if ( context != nullptr )
+      fizzy_free_execution_context( context );
+}
+
+instance_pool::instance_pool( std::vector< std::string > global_exports, std::size_t max_idle ) :
+   _global_exports( std::move( global_exports ) ),
+   _max_idle( max_idle ) {}
+
+instance_pool::~instance_pool()
+{
+   std::lock_guard< std::mutex > lock( _mutex );
+   _idle.clear();
+}
+
+std::unique_ptr< pooled_instance > instance_pool::acquire()
+{
+   std::lock_guard< std::mutex > lock( _mutex );
+
+   if ( _idle.empty() )
+      return {};
+
+   auto handle = std::move( _idle.back() );
+   _idle.pop_back();
+   return handle;
+}
+
+void instance_pool::prepare( pooled_instance& handle )
+{
+   handle.globals.clear();
+   handle.globals.reserve( _global_exports.size() );
+
+   for ( const auto& name : _global_exports )
+   {
+      FizzyExternalGlobal global;
+      if ( !fizzy_find_exported_global( handle.instance, name.c_str(), &global ) || global.value == nullptr )
+         return;
+
+      handle.globals.push_back( global.value );
+   }
+
+   std::lock_guard< std::mutex > lock( _mutex );
+
+   // Instantiation is deterministic, so the first instance is the snapshot for every other instance
+   if ( !_has_snapshot )
+   {
+      const auto* data = fizzy_get_instance_memory_data( handle.instance );
+      const auto size  = fizzy_get_instance_memory_size( handle.instance );
+
+      if ( data != nullptr )
+         _memory.assign( data, data + size );
+
+      _global_values.clear();
+      for ( const auto* value : handle.globals )
+         _global_values.push_back( *value );
+
+      _has_snapshot = true;
+   }
+
+   handle.poolable = true;
+}
+
+void instance_pool::release( std::unique_ptr< pooled_instance > handle ) noexcept
+{
+   if ( !handle || !handle->poolable )
+      return;
+
+   handle->runner = nullptr;
+
+   {
+      std::lock_guard< std::mutex > lock( _mutex );
+      if ( !_has_snapshot || _idle.size() >= _max_idle )
+         return;
+   }
+
+   // The snapshot is immutable once taken, so it is read without the lock.
+   // Linear memory cannot shrink, so an instance that grew its memory is discarded.
+   auto* data = fizzy_get_instance_memory_data( handle->instance );
+   if ( fizzy_get_instance_memory_size( handle->instance ) != _memory.size() )
+      return;
+
+   if ( data != nullptr )
+      std::memcpy( data, _memory.data(), _memory.size() );
+
+   for ( std::size_t i = 0; i < handle->globals.size(); i++ )
+      *handle->globals[ i ] = _global_values[ i ];
+
+   try
+   {
+      std::lock_guard< std::mutex > lock( _mutex );
+      if ( _idle.size() < _max_idle )
+         _idle.push_back( std::move( handle ) );
+   }
+   catch ( ... ) {}
+}
+
+namespace detail {
+
+constexpr std::size_t wasm_header_size  = 8;
+constexpr uint8_t     custom_section_id = 0;
+constexpr uint8_t     export_section_id = 7;
+constexpr uint8_t     global_export_kind = 3;
+
+bool read_leb128( const std::string& bytes, std::size_t& pos, uint32_t& value )
+{
+   value = 0;
+
+   for ( uint32_t shift = 0; shift < 35; shift += 7 )
+   {
+      if ( pos >= bytes.size() )
+         return false;
+
+      auto byte = uint8_t( bytes[ pos++ ] );
+      value |= uint32_t( byte & 0x7f ) << shift;
+
+      if ( !( byte & 0x80 ) )
+         return true;
+   }
+
+   return false;
+}
+
+void write_leb128( std::string& bytes, uint32_t value )
+{
+   do
+   {
+      auto byte = uint8_t( value & 0x7f );
+      value >>= 7;
+
+      if ( value )
+         byte |= 0x80;
+
+      bytes.push_back( char( byte ) );
+   } while ( value );
+}
+
+// Position of a known section in the order required by the binary format
+uint32_t section_order( uint8_t id )
+{
+   switch ( id )
+   {
+      case 12: // Data count
+         return 10;
+      case 10: // Code
+         return 11;
+      case 11: // Data
+         return 12;
+      default:
+         return id;
+   }
+}
+
+void append_section( std::string& bytes, uint8_t id, const std::string& payload )
+{
+   bytes.push_back( char( id ) );
+   write_leb128( bytes, uint32_t( payload.size() ) );
+   bytes += payload;
+}
+
+} // detail
+
+std::optional< std::string > export_globals( const std::string& bytecode, const std::vector< std::pair< uint32_t, std::string > >& globals )
+{
+   if ( bytecode.size() < detail::wasm_header_size )
+      return {};
+
+   std::string entries;
+   for ( const auto& [ index, name ] : globals )
+   {
+      detail::write_leb128( entries, uint32_t( name.size() ) );
+      entries += name;
+      entries.push_back( char( detail::global_export_kind ) );
+      detail::write_leb128( entries, index );
+   }
+
+   std::string result = bytecode.substr( 0, detail::wasm_header_size );
+   result.reserve( bytecode.size() + entries.size() + 16 );
+
+   bool exported = false;
+   std::size_t pos = detail::wasm_header_size;
+
+   while ( pos < bytecode.size() )
+   {
+      const std::size_t section_start = pos;
+      const auto id = uint8_t( bytecode[ pos++ ] );
+
+      uint32_t size;
+      if ( !detail::read_leb128( bytecode, pos, size ) || size > bytecode.size() - pos )
+         return {};
+
+      const std::size_t payload_start = pos;
+      pos += size;
+
+      if ( id == detail::export_section_id )
+      {
+         if ( exported )
+            return {};
+
+         std::size_t entries_start = payload_start;
+         uint32_t count;
+         if ( !detail::read_leb128( bytecode, entries_start, count ) || entries_start > pos )
+            return {};
+
+         std::string payload;
+         detail::write_leb128( payload, count + uint32_t( globals.size() ) );
+         payload.append( bytecode, entries_start, pos - entries_start );
+         payload += entries;
+
+         detail::append_section( result, id, payload );
+         exported = true;
+         continue;
+      }
+
+      if ( !exported && id != detail::custom_section_id && detail::section_order( id ) > detail::section_order( detail::export_section_id ) )
+      {
+         std::string payload;
+         detail::write_leb128( payload, uint32_t( globals.size() ) );
+         payload += entries;
+
+         detail::append_section( result, detail::export_section_id, payload );
+         exported = true;
+      }
+
+      result.append( bytecode, section_start, pos - section_start );
+   }
+
+   if ( !exported )
+   {
+      std::string payload;
+      detail::write_leb128( payload, uint32_t( globals.size() ) );
+      payload += entries;
+
+      detail::append_section( result, detail::export_section_id, payload );
+   }
+
+   return result;
+}
+
+} // koinos::vm_manager::fizzy
@@ -1,50 +1,124 @@
 #include <koinos/vm_manager/fizzy/module_cache.hpp>
 #include <koinos/vm_manager/fizzy/exceptions.hpp>
 
+#include <functional>
+#include <iterator>
+
 namespace koinos::vm_manager::fizzy {
 
-module_cache::module_cache( std::size_t size ) : _cache_size( size ) {}
+module_cache::module_cache( std::size_t capacity_bytes ) :
+   _capacity( capacity_bytes ) {}
 
 module_cache::~module_cache()
 {
-   std::lock_guard< std::mutex > lock( _mutex );
-   _module_map.clear();
+   for ( auto& s : _shards )
+   {
+      std::lock_guard< std::mutex > lock( s.mutex );
+      s.module_map.clear();
+      s.lru_list.clear();
+   }
+}
+
+std::size_t module_cache::get_shard_index( const std::string& id ) const
+{
+   return std::hash< std::string >{}( id ) % num_shards;
+}
+
+void module_cache::erase( shard& s, typename lru_list_type::iterator itr )
+{
+   s.bytes -= itr->bytes;
+   _bytes  -= itr->bytes;
+   s.module_map.erase( itr->id );
+   s.lru_list.erase( itr );
+}
+
+void module_cache::evict( shard& s, std::size_t keep )
+{
+   while ( _bytes > _capacity && s.lru_list.size() > keep )
+   {
+      erase( s, std::prev( s.lru_list.end() ) );
+      _evictions++;
+   }
 }
 
 module_ptr module_cache::get_module( const std::string& id )
 {
-   std::lock_guard< std::mutex > lock( _mutex );
+   auto& s = _shards[ get_shard_index( id ) ];
+   std::lock_guard< std::mutex > lock( s.mutex );
 
-   auto itr = _module_map.find( id );
-   if ( itr == _module_map.end() )
+   auto itr = s.module_map.find( id );
+   if ( itr == s.module_map.end() )
+   {
+      _misses++;
       return module_ptr();
+   }
 
-   // Erase the entry from the list and push front
-   _lru_list.erase( itr->second.second );
-   _lru_list.push_front( id );
-   auto ptr = itr->second.first;
-   _module_map[ id ] = std::make_pair( ptr, _lru_list.begin() );
+   // Move the entry to the front without reallocating it, keys in the map stay valid
+   s.lru_list.splice( s.lru_list.begin(), s.lru_list, itr->second );
+   _hits++;
 
-   return ptr;
+   return itr->second->module;
 }
 
-void module_cache::put_module( const std::string& id, module_ptr module )
+bool module_cache::contains( const std::string& id )
 {
-   std::lock_guard< std::mutex > lock( _mutex );
+   auto& s = _shards[ get_shard_index( id ) ];
+   std::lock_guard< std::mutex > lock( s.mutex );
+   return s.module_map.find( id ) != s.module_map.end();
+}
+
+void module_cache::put_module( const std::string& id, module_ptr module, std::size_t bytes )
+{
+   const auto index = get_shard_index( id );
 
-   // If the cache is full, remove the last entry from the map, free the fizzy module, and pop back
-   if ( _lru_list.size() >= _cache_size )
    {
-      const auto key = _lru_list.back();
-      auto it = _module_map.find( key );
-      if ( it != _module_map.end() )
-         _module_map.erase( it );
+      auto& s = _shards[ index ];
+      std::lock_guard< std::mutex > lock( s.mutex );
+
+      // Another thread may have parsed the same module concurrently
+      if ( auto itr = s.module_map.find( id ); itr != s.module_map.end() )
+         erase( s, itr->second );
+
+      if ( bytes > _capacity )
+      {
+         _rejected++;
+         return;
+      }
+
+      s.lru_list.push_front( entry{ id, module, bytes } );
+      s.module_map.emplace( s.lru_list.front().id, s.lru_list.begin() );
+      s.bytes += bytes;
+      _bytes  += bytes;
+
+      evict( s, 1 );
+   }
 
-      _lru_list.pop_back();
+   // The module's own shard could not make room, so the other shards are evicted in turn.
+   // Concurrent inserts may briefly exceed the capacity until each finishes evicting.
+   for ( std::size_t i = 1; i < num_shards && _bytes > _capacity; i++ )
+   {
+      auto& s = _shards[ ( index + i ) % num_shards ];
+      std::lock_guard< std::mutex > lock( s.mutex );
+      evict( s, 0 );
+   }
+}
+
+module_cache_stats module_cache::stats()
+{
+   module_cache_stats result;
+   result.hits      = _hits;
+   result.misses    = _misses;
+   result.evictions = _evictions;
+   result.rejected  = _rejected;
+
+   for ( auto& s : _shards )
+   {
+      std::lock_guard< std::mutex > lock( s.mutex );
+      result.modules += s.lru_list.size();
+      result.bytes   += s.bytes;
    }
 
-   _lru_list.push_front( id );
-   _module_map[ id ] = std::make_pair( module, _lru_list.begin() );
+   return result;
 }
 
 } // koinos::vm_manager::fizzy
@@ -0,0 +1,214 @@
+#include <koinos/vm_manager/fizzy/module_store.hpp>
+
+#include <koinos/crypto/multihash.hpp>
+#include <koinos/log.hpp>
+#include <koinos/util/conversion.hpp>
+#include <koinos/util/hex.hpp>
+
+#include <boost/crc.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <utility>
+
+namespace koinos::vm_manager::fizzy {
+
+namespace constants {
+   constexpr char        module_file_magic[ 4 ]   = { 'F', 'Z', 'M', 'D' };
+   constexpr uint32_t    module_file_version      = 1;
+   constexpr std::size_t module_file_header_size  = sizeof( module_file_magic ) + sizeof( uint32_t ) + sizeof( uint64_t ) + sizeof( uint32_t );
+   constexpr const char* module_file_tmp_extension = ".tmp";
+}
+
+namespace detail {
+
+uint32_t checksum( const char* data, std::size_t size )
+{
+   boost::crc_32_type crc;
+   crc.process_bytes( data, size );
+   return crc.checksum();
+}
+
+std::string make_header( const std::string& bytecode )
+{
+   std::string header( constants::module_file_header_size, '\0' );
+   uint32_t version = constants::module_file_version;
+   uint64_t size    = bytecode.size();
+   uint32_t crc     = checksum( bytecode.data(), bytecode.size() );
+
+   auto* ptr = header.data();
+   std::memcpy( ptr, constants::module_file_magic, sizeof( constants::module_file_magic ) );
+   ptr += sizeof( constants::module_file_magic );
+   std::memcpy( ptr, &version, sizeof( version ) );
+   ptr += sizeof( version );
+   std::memcpy( ptr, &size, sizeof( size ) );
+   ptr += sizeof( size );
+   std::memcpy( ptr, &crc, sizeof( crc ) );
+
+   return header;
+}
+
+bool check_file( const char* data, std::size_t file_size )
+{
+   if ( file_size < constants::module_file_header_size )
+      return false;
+
+   if ( std::memcmp( data, constants::module_file_magic, sizeof( constants::module_file_magic ) ) != 0 )
+      return false;
+
+   uint32_t version;
+   uint64_t size;
+   uint32_t crc;
+
+   const auto* ptr = data + sizeof( constants::module_file_magic );
+   std::memcpy( &version, ptr, sizeof( version ) );
+   ptr += sizeof( version );
+   std::memcpy( &size, ptr, sizeof( size ) );
+   ptr += sizeof( size );
+   std::memcpy( &crc, ptr, sizeof( crc ) );
+
+   if ( version != constants::module_file_version )
+      return false;
+
+   if ( size != file_size - constants::module_file_header_size )
+      return false;
+
+   return crc == checksum( data + constants::module_file_header_size, size );
+}
+
+// Module ids are the multihash of the bytecode, so the bytecode is hashed with the id's hash code
+bool check_id( const std::string& id, const std::string& bytecode )
+{
+   try
+   {
+      auto expected = util::converter::to< crypto::multihash >( id );
+      return crypto::hash( expected.code(), bytecode, crypto::digest_size( expected.digest().size() ) ) == expected;
+   }
+   catch ( ... )
+   {
+      return false;
+   }
+}
+
+} // detail
+
+module_store::module_store( const std::filesystem::path& dir ) :
+   _dir( dir )
+{
+   std::filesystem::create_directories( _dir );
+}
+
+std::filesystem::path module_store::path_for( const std::string& id ) const
+{
+   return _dir / util::to_hex( id );
+}
+
+bool module_store::contains( const std::string& id ) const
+{
+   std::error_code ec;
+   return std::filesystem::exists( path_for( id ), ec );
+}
+
+std::optional< std::string > module_store::get( const std::string& id ) const
+{
+   auto path = path_for( id );
+
+   try
+   {
+      if ( !std::filesystem::exists( path ) || std::filesystem::file_size( path ) == 0 )
+         return {};
+
+      boost::interprocess::file_mapping file( path.c_str(), boost::interprocess::read_only );
+      boost::interprocess::mapped_region region( file, boost::interprocess::read_only );
+
+      const auto* data = static_cast< const char* >( region.get_address() );
+      const auto size  = region.get_size();
+
+      if ( detail::check_file( data, size ) )
+      {
+         std::string bytecode( data + constants::module_file_header_size, size - constants::module_file_header_size );
+
+         if ( detail::check_id( id, bytecode ) )
+            return bytecode;
+
+         LOG(warning) << "Removing module file " << path.string() << " that does not match its id";
+      }
+      else
+      {
+         LOG(warning) << "Removing corrupt module file " << path.string();
+      }
+   }
+   catch ( const std::exception& e )
+   {
+      LOG(warning) << "Could not read module file " << path.string() << ": " << e.what();
+   }
+
+   std::error_code ec;
+   std::filesystem::remove( path, ec );
+   return {};
+}
+
+void module_store::put( const std::string& id, const std::string& bytecode ) const
+{
+   auto path = path_for( id );
+   auto tmp  = path;
+   tmp += constants::module_file_tmp_extension;
+
+   {
+      std::ofstream ofs( tmp, std::ios::binary | std::ios::trunc );
+      ofs << detail::make_header( bytecode ) << bytecode;
+      ofs.close();
+
+      if ( !ofs )
+      {
+         std::error_code ec;
+         std::filesystem::remove( tmp, ec );
+         return;
+      }
+   }
+
+   // Renaming is atomic, so a crash never leaves a partially written module behind
+   std::filesystem::rename( tmp, path );
+}
+
+std::vector< std::string > module_store::ids() const
+{
+   std::vector< std::pair< std::filesystem::file_time_type, std::string > > files;
+
+   // Called from the preload thread, so filesystem errors end the listing instead of throwing
+   std::error_code ec;
+   for ( std::filesystem::directory_iterator itr( _dir, ec ), end; !ec && itr != end; itr.increment( ec ) )
+   {
+      std::error_code entry_ec;
+      if ( !itr->is_regular_file( entry_ec ) || itr->path().extension() == constants::module_file_tmp_extension )
+         continue;
+
+      auto time = itr->last_write_time( entry_ec );
+      if ( entry_ec )
+         continue;
+
+      try
+      {
+         files.emplace_back( time, util::from_hex< std::string >( itr->path().filename().string() ) );
+      }
+      catch ( ... ) {}
+   }
+
+   if ( ec )
+      LOG(warning) << "Could not list module directory " << _dir.string() << ": " << ec.message();
+
+   std::sort( files.begin(), files.end(), []( const auto& a, const auto& b ) { return a.first > b.first; } );
+
+   std::vector< std::string > result;
+   result.reserve( files.size() );
+   for ( auto& [ time, id ] : files )
+      result.emplace_back( std::move( id ) );
+
+   return result;
+}
+
+} // koinos::vm_manager::fizzy
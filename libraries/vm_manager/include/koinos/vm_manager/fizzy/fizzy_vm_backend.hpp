@@ -1,11 +1,15 @@
 #pragma once
 
 #include <koinos/vm_manager/fizzy/module_cache.hpp>
+#include <koinos/vm_manager/fizzy/module_store.hpp>
 #include <koinos/vm_manager/vm_backend.hpp>
 
 #include <koinos/chain/chain.pb.h>
 
+#include <atomic>
+#include <memory>
 #include <string>
+#include <thread>
 
 namespace koinos::vm_manager::fizzy {
 
@@ -15,16 +19,25 @@ namespace koinos::vm_manager::fizzy {
 class fizzy_vm_backend : public vm_backend
 {
    public:
-      fizzy_vm_backend();
+      fizzy_vm_backend( std::size_t module_cache_size = default_module_cache_size );
       virtual ~fizzy_vm_backend();
 
       virtual std::string backend_name();
       virtual void initialize();
 
       virtual void run( abstract_host_api& hapi, const std::string& bytecode, const std::string& id = std::string() );
+      virtual void set_module_directory( const std::filesystem::path& dir );
+
+      module_cache_stats cache_stats();
 
    private:
-      module_cache _cache;
+      void preload_modules();
+
+      const std::size_t               _cache_size;
+      module_cache                    _cache;
+      std::unique_ptr< module_store > _store;
+      std::atomic_bool                _stopped = false;
+      std::thread                     _preload_thread;
 };
 
 } // koinos::vm_manager::fizzy
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <fizzy/fizzy.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace koinos::vm_manager::fizzy {
+
+/**
+ * An instantiated module and its execution context, used by at most one runner at a time.
+ */
+struct pooled_instance
+{
+   pooled_instance() = default;
+   pooled_instance( const pooled_instance& ) = delete;
+   pooled_instance& operator=( const pooled_instance& ) = delete;
+   ~pooled_instance();
+
+   FizzyInstance*             instance = nullptr;
+   FizzyExecutionContext*     context  = nullptr;
+
+   // Context passed to host functions. The instance is bound to it at instantiation, so the
+   // runner currently using the instance is set here on every acquire.
+   void*                      runner   = nullptr;
+
+   std::vector< FizzyValue* > globals;
+   bool                       poolable = false;
+};
+
+/**
+ * A pool of instances of a single module that are reset to their post-instantiation state between runs.
+ *
+ * The first instance prepared by the pool provides a snapshot of linear memory and of every mutable
+ * global. Released instances are restored from that snapshot. Mutable globals can only be reached
+ * through exports, so pooled modules are rewritten with export_globals before they are parsed.
+ */
+class instance_pool
+{
+   public:
+      instance_pool( std::vector< std::string > global_exports, std::size_t max_idle );
+      ~instance_pool();
+
+      std::unique_ptr< pooled_instance > acquire();
+      void prepare( pooled_instance& handle );
+      void release( std::unique_ptr< pooled_instance > handle ) noexcept;
+
+   private:
+      const std::vector< std::string >                  _global_exports;
+      const std::size_t                                 _max_idle;
+
+      std::mutex                                        _mutex;
+      bool                                              _has_snapshot = false;
+      std::vector< uint8_t >                            _memory;
+      std::vector< FizzyValue >                         _global_values;
+      std::vector< std::unique_ptr< pooled_instance > > _idle;
+};
+
+/**
+ * Adds an export for each (global index, export name) pair to a WebAssembly binary.
+ *
+ * Returns an empty optional if the binary cannot be rewritten.
+ */
+std::optional< std::string > export_globals( const std::string& bytecode, const std::vector< std::pair< uint32_t, std::string > >& globals );
+
+} // koinos::vm_manager::fizzy
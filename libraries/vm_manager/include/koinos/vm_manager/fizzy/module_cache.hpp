@@ -1,51 +1,104 @@
+#pragma once
+
 #include <fizzy/fizzy.h>
 
+#include <koinos/vm_manager/fizzy/instance_pool.hpp>
+
+#include <array>
+#include <atomic>
 #include <list>
-#include <map>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 
 namespace koinos::vm_manager::fizzy {
 
 class module_guard {
    private:
-      const FizzyModule* _module;
+      const FizzyModule*               _module;
+      std::unique_ptr< instance_pool > _pool;
 
    public:
-      module_guard( const FizzyModule* m ) : _module(m) {}
-      ~module_guard() { fizzy_free_module( _module ); }
+      module_guard( const FizzyModule* m, std::unique_ptr< instance_pool > pool = nullptr ) : _module(m), _pool( std::move( pool ) ) {}
+      ~module_guard()
+      {
+         // Pooled instances reference the module and must be freed first
+         _pool.reset();
+         fizzy_free_module( _module );
+      }
 
       const FizzyModule* get() const { return _module; }
+      instance_pool* pool() const { return _pool.get(); }
 };
 
 using module_ptr = std::shared_ptr< const module_guard >;
 
+struct module_cache_stats
+{
+   uint64_t hits      = 0;
+   uint64_t misses    = 0;
+   uint64_t evictions = 0;
+   uint64_t rejected  = 0;
+   uint64_t modules   = 0;
+   uint64_t bytes     = 0;
+};
+
+/**
+ * A concurrent LRU cache of parsed modules bounded by the total bytecode size of its modules.
+ *
+ * Modules are spread over independently locked shards by id, so lookups of different contracts
+ * do not contend on a single lock. The capacity is shared by every shard. A module that does not
+ * fit evicts the least recently used modules of its own shard first, then of the other shards,
+ * holding one shard lock at a time. Only modules larger than the whole capacity are rejected.
+ */
 class module_cache
 {
    private:
-      using lru_list_type = std::list< std::string >;
-
-      using module_map_type =
-         std::map<
-            std::string,
-            std::pair<
-               module_ptr,
-               typename lru_list_type::iterator
-            >
-         >;
-
-      lru_list_type     _lru_list;
-      module_map_type   _module_map;
-      std::mutex        _mutex;
-      const std::size_t _cache_size;
+      static constexpr std::size_t num_shards = 16;
+
+      struct entry
+      {
+         std::string id;
+         module_ptr  module;
+         std::size_t bytes;
+      };
+
+      using lru_list_type = std::list< entry >;
+
+      struct shard
+      {
+         std::mutex                                                             mutex;
+         lru_list_type                                                          lru_list;
+         std::unordered_map< std::string_view, typename lru_list_type::iterator > module_map;
+         std::size_t                                                            bytes = 0;
+      };
+
+      std::array< shard, num_shards > _shards;
+      const std::size_t               _capacity;
+      std::atomic< std::size_t >      _bytes     = 0;
+
+      std::atomic< uint64_t >         _hits      = 0;
+      std::atomic< uint64_t >         _misses    = 0;
+      std::atomic< uint64_t >         _evictions = 0;
+      std::atomic< uint64_t >         _rejected  = 0;
+
+      std::size_t get_shard_index( const std::string& id ) const;
+
+      // Evicts least recently used modules of the shard until the cache fits, keeping at least keep modules
+      void evict( shard& s, std::size_t keep );
+      void erase( shard& s, typename lru_list_type::iterator itr );
 
    public:
-      module_cache( std::size_t size );
+      module_cache( std::size_t capacity_bytes );
       ~module_cache();
 
       module_ptr get_module( const std::string& id );
-      void put_module( const std::string& id, module_ptr module );
+      bool contains( const std::string& id );
+      void put_module( const std::string& id, module_ptr module, std::size_t bytes );
+
+      module_cache_stats stats();
 };
 
 } // koinos::vm_manager::fizzy
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace koinos::vm_manager::fizzy {
+
+/**
+ * An on-disk store of module bytecode keyed by module id (the contract hash).
+ *
+ * Fizzy cannot serialize a parsed module, so the store holds the bytecode of every module
+ * the backend has parsed and is used to parse them again ahead of time after a restart.
+ * Each file carries a format version and a checksum, and its bytecode must hash to the module
+ * id. Files that fail any check are removed and the module is parsed from state on first use
+ * instead.
+ */
+class module_store
+{
+   public:
+      module_store( const std::filesystem::path& dir );
+
+      bool contains( const std::string& id ) const;
+      std::optional< std::string > get( const std::string& id ) const;
+      void put( const std::string& id, const std::string& bytecode ) const;
+
+      /**
+       * Ids of all stored modules, most recently stored first. Does not throw.
+       */
+      std::vector< std::string > ids() const;
+
+   private:
+      std::filesystem::path path_for( const std::string& id ) const;
+
+      const std::filesystem::path _dir;
+};
+
+} // koinos::vm_manager::fizzy
@@ -19,6 +19,12 @@ class abstract_host_api
       virtual int32_t invoke_system_call( uint32_t xid, char* ret_ptr, uint32_t ret_len, const char* arg_ptr, uint32_t arg_len, uint32_t* bytes_written  ) = 0;
       virtual int64_t get_meter_ticks()const = 0;
       virtual void use_meter_ticks( uint64_t meter_ticks ) = 0;
+
+      /**
+       * True once the running contract has exited successfully. The backend stops execution
+       * and returns from run() normally, successful exits are not signaled with an exception.
+       */
+      virtual bool exited() const = 0;
 };
 
 } // koinos::vm_manager
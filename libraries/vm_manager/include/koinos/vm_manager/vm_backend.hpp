@@ -2,17 +2,29 @@
 
 #include <koinos/vm_manager/host_api.hpp>
 
+#include <cstddef>
+#include <filesystem>
 #include <memory>
 #include <string>
 #include <vector>
 
 namespace koinos::vm_manager {
 
+// Default bound on the total bytecode size of the modules a backend keeps parsed
+constexpr std::size_t default_module_cache_size = 64 * 1024 * 1024;
+
 /**
  * Abstract class for WebAssembly virtual machines.
  *
  * To add a new WebAssembly VM, you need to implement this class
  * and return it in get_vm_backends().
+ *
+ * Backends are interchangeable at runtime, so every backend must produce
+ * identical results and charge identical compute for the same bytecode.
+ * Execution is metered in the same ticks as fizzy: the remaining budget is
+ * read from abstract_host_api::get_meter_ticks() when a run starts and the
+ * ticks consumed by wasm are reported through use_meter_ticks() before every
+ * host call and when the run ends.
  */
 class vm_backend
 {
@@ -29,20 +41,29 @@ class vm_backend
 
       /**
        * Run some bytecode.
+       *
+       * Returns normally when the bytecode finishes or exits successfully, see
+       * abstract_host_api::exited(). Errors are thrown.
        */
       virtual void run( abstract_host_api& hapi, const std::string& bytecode, const std::string& id = std::string() ) = 0;
+
+      /**
+       * Persist modules in a directory so they can be loaded ahead of use after a restart.
+       * Optional, backends without a persistent cache ignore it. Must be called before run().
+       */
+      virtual void set_module_directory( const std::filesystem::path& dir );
 };
 
 /**
  * Get a list of available VM backends.
  */
-std::vector< std::shared_ptr< vm_backend > > get_vm_backends();
+std::vector< std::shared_ptr< vm_backend > > get_vm_backends( std::size_t module_cache_size = default_module_cache_size );
 
 std::string get_default_vm_backend_name();
 
 /**
  * Get a shared_ptr to the named VM backend.
  */
-std::shared_ptr< vm_backend > get_vm_backend( const std::string& name = get_default_vm_backend_name() );
+std::shared_ptr< vm_backend > get_vm_backend( const std::string& name = get_default_vm_backend_name(), std::size_t module_cache_size = default_module_cache_size );
 
 } // koinos::vm_manager
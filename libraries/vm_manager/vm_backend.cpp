@@ -11,11 +11,13 @@ namespace koinos::vm_manager {
 vm_backend::vm_backend() {}
 vm_backend::~vm_backend() {}
 
-std::vector< std::shared_ptr< vm_backend > > get_vm_backends()
+void vm_backend::set_module_directory( const std::filesystem::path& dir ) {}
+
+std::vector< std::shared_ptr< vm_backend > > get_vm_backends( std::size_t module_cache_size )
 {
    std::vector< std::shared_ptr< vm_backend > > result;
 
-   result.push_back( std::make_shared< vm_manager::fizzy::fizzy_vm_backend >() );
+   result.push_back( std::make_shared< vm_manager::fizzy::fizzy_vm_backend >( module_cache_size ) );
 
    return result;
 }
@@ -25,9 +27,9 @@ std::string get_default_vm_backend_name()
    return "fizzy";
 }
 
-std::shared_ptr< vm_backend > get_vm_backend( const std::string& name )
+std::shared_ptr< vm_backend > get_vm_backend( const std::string& name, std::size_t module_cache_size )
 {
-   std::vector< std::shared_ptr< vm_backend > > backends = get_vm_backends();
+   std::vector< std::shared_ptr< vm_backend > > backends = get_vm_backends( module_cache_size );
    for( std::shared_ptr< vm_backend > b : backends )
    {
       if( b->backend_name() == name )
@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <chrono>
 #include <cstdlib>
 #include <filesystem>
 #include <fstream>
@@ -13,11 +14,15 @@
 
 #include <yaml-cpp/yaml.h>
 
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+#include <google/protobuf/util/delimited_message_util.h>
 #include <google/protobuf/util/json_util.h>
 
 #include <koinos/chain/constants.hpp>
 #include <koinos/chain/controller.hpp>
 #include <koinos/chain/indexer.hpp>
+#include <koinos/chain/request_scheduler.hpp>
 #include <koinos/chain/state.hpp>
 #include <koinos/crypto/multihash.hpp>
 #include <koinos/exception.hpp>
@@ -34,6 +39,7 @@
 #include <koinos/util/options.hpp>
 #include <koinos/util/random.hpp>
 #include <koinos/util/services.hpp>
+#include <koinos/vm_manager/vm_backend.hpp>
 
 #include "git_version.h"
 
@@ -68,6 +74,35 @@
 #define SYSTEM_CALL_BUFFER_SIZE_DEFAULT     64'000
 #define FORK_ALGORITHM_OPTION               "fork-algorithm"
 #define FORK_ALGORITHM_DEFAULT              FIFO_ALGORITHM
+#define INDEXER_REQUESTS_OPTION             "indexer-requests"
+#define INDEXER_REQUESTS_DEFAULT            4
+#define INDEXER_QUEUE_LIMIT_OPTION          "indexer-queue-limit"
+#define INDEXER_QUEUE_LIMIT_DEFAULT         512'000'000
+#define VM_BACKEND_OPTION                   "vm-backend"
+#define MODULE_CACHE_SIZE_OPTION            "module-cache-size"
+#define MODULE_DIR_OPTION                   "module-dir"
+#define MODULE_DIR_DEFAULT                  "modules"
+#define PARALLEL_TRANSACTIONS_OPTION        "parallel-transactions"
+#define PARALLEL_TRANSACTIONS_DEFAULT       false
+#define READ_CONTRACT_CACHE_SIZE_OPTION     "read-contract-cache-size"
+#define READ_CONTRACT_CACHE_SIZE_DEFAULT    0
+#define PARALLEL_BATCH_REQUESTS_OPTION      "parallel-batch-requests"
+#define PARALLEL_BATCH_REQUESTS_DEFAULT     false
+#define MAX_BATCH_SIZE_OPTION               "max-batch-size"
+#define MAX_BATCH_SIZE_DEFAULT              uint64_t( chain::default_max_batch_size )
+#define BLOCK_THREADS_OPTION                "block-threads"
+#define BLOCK_THREADS_DEFAULT               uint64_t( 1 )
+#define BLOCK_QUEUE_DEPTH_OPTION            "block-queue-depth"
+#define BLOCK_QUEUE_DEPTH_DEFAULT           uint64_t( 0 )
+#define TRANSACTION_THREADS_OPTION          "transaction-threads"
+#define TRANSACTION_QUEUE_DEPTH_OPTION      "transaction-queue-depth"
+#define TRANSACTION_QUEUE_DEPTH_DEFAULT     uint64_t( 64 )
+#define READ_THREADS_OPTION                 "read-threads"
+#define READ_QUEUE_DEPTH_OPTION             "read-queue-depth"
+#define READ_QUEUE_DEPTH_DEFAULT            uint64_t( 64 )
+#define REQUEST_STATS_INTERVAL_OPTION       "request-stats-interval"
+#define REQUEST_STATS_INTERVAL_DEFAULT      uint64_t( 60 )
+
 
 KOINOS_DECLARE_EXCEPTION( service_exception );
 KOINOS_DECLARE_DERIVED_EXCEPTION( invalid_argument, service_exception );
@@ -76,16 +111,21 @@ using namespace boost;
 using namespace koinos;
 
 const std::string& version_string();
-void attach_request_handler( chain::controller& controller, mq::request_handler& reqhandler );
+void attach_request_handler( chain::controller& controller, mq::request_handler& reqhandler, chain::request_scheduler& scheduler );
+void attach_batch_request_handler( chain::controller& controller, mq::request_handler& reqhandler, chain::request_scheduler& scheduler, bool parallel );
+void log_request_stats( asio::steady_timer& timer, const chain::request_scheduler& scheduler, std::chrono::seconds interval );
 
 int main( int argc, char** argv )
 {
-   std::string amqp_url, log_level, log_dir, instance_id, fork_algorithm_option;
-   std::filesystem::path statedir, genesis_data_file;
+   std::string amqp_url, log_level, log_dir, instance_id, fork_algorithm_option, vm_backend_name;
+   std::filesystem::path statedir, genesis_data_file, module_dir;
    uint64_t jobs, read_compute_limit;
    int32_t syscall_bufsize;
+   uint32_t indexer_requests;
+   uint64_t indexer_queue_limit, module_cache_size, read_contract_cache_size;
+   uint64_t max_batch_size, block_threads, block_queue_depth, transaction_threads, transaction_queue_depth, read_threads, read_queue_depth, request_stats_interval;
    chain::genesis_data genesis_data;
-   bool reset, log_color, log_datetime;
+   bool reset, log_color, log_datetime, parallel_transactions, parallel_batch_requests;
    chain::fork_resolution_algorithm fork_algorithm;
 
    try
@@ -109,7 +149,23 @@ int main( int argc, char** argv )
          (LOG_DIR_OPTION                        , program_options::value< std::string >(), "The logging directory")
          (LOG_COLOR_OPTION                      , program_options::value< bool >(), "Log color toggle")
          (LOG_DATETIME_OPTION                   , program_options::value< bool >(), "Log datetime on console toggle")
-         (SYSTEM_CALL_BUFFER_SIZE_OPTION        , program_options::value< uint32_t >(), "System call RPC invocation buffer size");
+         (SYSTEM_CALL_BUFFER_SIZE_OPTION        , program_options::value< uint32_t >(), "System call RPC invocation buffer size")
+         (INDEXER_REQUESTS_OPTION               , program_options::value< uint32_t >(), "The number of block store requests the indexer keeps in flight")
+         (INDEXER_QUEUE_LIMIT_OPTION            , program_options::value< uint64_t >(), "The maximum size in bytes of blocks queued by the indexer")
+         (VM_BACKEND_OPTION                     , program_options::value< std::string >(), "The WebAssembly VM backend to use")
+         (MODULE_CACHE_SIZE_OPTION              , program_options::value< uint64_t >(), "The maximum total bytecode size in bytes of cached contract modules")
+         (MODULE_DIR_OPTION                     , program_options::value< std::string >(), "The directory contract modules are persisted in across restarts, empty to disable")
+         (PARALLEL_TRANSACTIONS_OPTION          , program_options::value< bool >(), "Apply the transactions of a block speculatively in parallel")
+         (READ_CONTRACT_CACHE_SIZE_OPTION       , program_options::value< uint64_t >(), "The maximum number of read contract results cached for the head block, 0 to disable")
+         (PARALLEL_BATCH_REQUESTS_OPTION        , program_options::value< bool >(), "Execute the requests of a batch RPC in parallel")
+         (MAX_BATCH_SIZE_OPTION                 , program_options::value< uint64_t >(), "The maximum number of requests in a batch RPC")
+         (BLOCK_THREADS_OPTION                  , program_options::value< uint64_t >(), "The number of block submissions handled concurrently")
+         (BLOCK_QUEUE_DEPTH_OPTION              , program_options::value< uint64_t >(), "The number of block submissions that may wait to be handled, 0 for no limit")
+         (TRANSACTION_THREADS_OPTION            , program_options::value< uint64_t >(), "The number of transaction submissions handled concurrently, defaults to jobs")
+         (TRANSACTION_QUEUE_DEPTH_OPTION        , program_options::value< uint64_t >(), "The number of transaction submissions that may wait to be handled before new ones are rejected")
+         (READ_THREADS_OPTION                   , program_options::value< uint64_t >(), "The number of read requests handled concurrently, defaults to jobs")
+         (READ_QUEUE_DEPTH_OPTION               , program_options::value< uint64_t >(), "The number of read requests that may wait to be handled before new ones are rejected")
+         (REQUEST_STATS_INTERVAL_OPTION         , program_options::value< uint64_t >(), "The interval in seconds between request queue statistics logs, 0 to disable");
 
       program_options::variables_map args;
       program_options::store( program_options::parse_command_line( argc, argv, options ), args );
@@ -162,6 +218,22 @@ int main( int argc, char** argv )
       read_compute_limit    = util::get_option< uint64_t >( READ_COMPUTE_BANDWITH_LIMIT_OPTION, READ_COMPUTE_BANDWITH_LIMIT_DEFAULT, args, chain_config, global_config );
       fork_algorithm_option = util::get_option< std::string >( FORK_ALGORITHM_OPTION, FORK_ALGORITHM_DEFAULT, args, chain_config, global_config );
       syscall_bufsize       = util::get_option< uint32_t >( SYSTEM_CALL_BUFFER_SIZE_OPTION, SYSTEM_CALL_BUFFER_SIZE_DEFAULT, args, chain_config, global_config );
+      indexer_requests      = util::get_option< uint32_t >( INDEXER_REQUESTS_OPTION, INDEXER_REQUESTS_DEFAULT, args, chain_config, global_config );
+      indexer_queue_limit   = util::get_option< uint64_t >( INDEXER_QUEUE_LIMIT_OPTION, INDEXER_QUEUE_LIMIT_DEFAULT, args, chain_config, global_config );
+      vm_backend_name       = util::get_option< std::string >( VM_BACKEND_OPTION, vm_manager::get_default_vm_backend_name(), args, chain_config, global_config );
+      module_cache_size     = util::get_option< uint64_t >( MODULE_CACHE_SIZE_OPTION, vm_manager::default_module_cache_size, args, chain_config, global_config );
+      module_dir            = std::filesystem::path( util::get_option< std::string >( MODULE_DIR_OPTION, MODULE_DIR_DEFAULT, args, chain_config, global_config ) );
+      parallel_transactions = util::get_option< bool >( PARALLEL_TRANSACTIONS_OPTION, PARALLEL_TRANSACTIONS_DEFAULT, args, chain_config, global_config );
+      read_contract_cache_size = util::get_option< uint64_t >( READ_CONTRACT_CACHE_SIZE_OPTION, READ_CONTRACT_CACHE_SIZE_DEFAULT, args, chain_config, global_config );
+      parallel_batch_requests = util::get_option< bool >( PARALLEL_BATCH_REQUESTS_OPTION, PARALLEL_BATCH_REQUESTS_DEFAULT, args, chain_config, global_config );
+      max_batch_size        = util::get_option< uint64_t >( MAX_BATCH_SIZE_OPTION, MAX_BATCH_SIZE_DEFAULT, args, chain_config, global_config );
+      block_threads         = util::get_option< uint64_t >( BLOCK_THREADS_OPTION, BLOCK_THREADS_DEFAULT, args, chain_config, global_config );
+      block_queue_depth     = util::get_option< uint64_t >( BLOCK_QUEUE_DEPTH_OPTION, BLOCK_QUEUE_DEPTH_DEFAULT, args, chain_config, global_config );
+      transaction_threads   = util::get_option< uint64_t >( TRANSACTION_THREADS_OPTION, jobs, args, chain_config, global_config );
+      transaction_queue_depth = util::get_option< uint64_t >( TRANSACTION_QUEUE_DEPTH_OPTION, TRANSACTION_QUEUE_DEPTH_DEFAULT, args, chain_config, global_config );
+      read_threads          = util::get_option< uint64_t >( READ_THREADS_OPTION, jobs, args, chain_config, global_config );
+      read_queue_depth      = util::get_option< uint64_t >( READ_QUEUE_DEPTH_OPTION, READ_QUEUE_DEPTH_DEFAULT, args, chain_config, global_config );
+      request_stats_interval = util::get_option< uint64_t >( REQUEST_STATS_INTERVAL_OPTION, REQUEST_STATS_INTERVAL_DEFAULT, args, chain_config, global_config );
 
       std::optional< std::filesystem::path > logdir_path;
       if ( !log_dir.empty() )
@@ -176,6 +248,13 @@ int main( int argc, char** argv )
       LOG(info) << version_string();
 
       KOINOS_ASSERT( jobs > 1, invalid_argument, "jobs must be greater than 1" );
+      KOINOS_ASSERT( indexer_requests > 0, invalid_argument, "indexer requests must be greater than 0" );
+      KOINOS_ASSERT( block_threads > 0, invalid_argument, "block threads must be greater than 0" );
+      KOINOS_ASSERT( transaction_threads > 0, invalid_argument, "transaction threads must be greater than 0" );
+      KOINOS_ASSERT( transaction_queue_depth > 0, invalid_argument, "transaction queue depth must be greater than 0" );
+      KOINOS_ASSERT( read_threads > 0, invalid_argument, "read threads must be greater than 0" );
+      KOINOS_ASSERT( read_queue_depth > 0, invalid_argument, "read queue depth must be greater than 0" );
+      KOINOS_ASSERT( max_batch_size > 0, invalid_argument, "max batch size must be greater than 0" );
 
       if ( config.IsNull() )
       {
@@ -202,12 +281,21 @@ int main( int argc, char** argv )
          KOINOS_THROW( invalid_argument, "${a} is not a valid fork algorithm", ("a", fork_algorithm_option) );
       }
 
+      KOINOS_ASSERT(
+         vm_manager::get_vm_backend( vm_backend_name ),
+         invalid_argument,
+         "${b} is not a valid vm backend", ("b", vm_backend_name)
+      );
+
       if ( statedir.is_relative() )
          statedir = basedir / util::service::chain / statedir;
 
       if ( !std::filesystem::exists( statedir ) )
          std::filesystem::create_directories( statedir );
 
+      if ( !module_dir.empty() && module_dir.is_relative() )
+         module_dir = basedir / util::service::chain / module_dir;
+
       // Load genesis data
       if ( genesis_data_file.is_relative() )
          genesis_data_file = basedir / util::service::chain / genesis_data_file;
@@ -245,7 +333,21 @@ int main( int argc, char** argv )
    asio::io_context client_ioc, server_ioc, main_ioc;
    auto client = std::make_shared< mq::client >( client_ioc );
    auto request_handler = mq::request_handler( server_ioc );
-   chain::controller controller( read_compute_limit, syscall_bufsize );
+   chain::controller controller( read_compute_limit, syscall_bufsize, vm_backend_name, module_cache_size );
+
+   chain::request_scheduler scheduler(
+      chain::request_class_config { .threads = block_threads, .max_queue_depth = block_queue_depth },
+      chain::request_class_config { .threads = transaction_threads, .max_queue_depth = transaction_queue_depth },
+      chain::request_class_config { .threads = read_threads, .max_queue_depth = read_queue_depth }
+   );
+
+   // Request handlers wait on the scheduler, so every request that may be admitted needs a handler thread.
+   // Blocks always have a thread, however many transactions and reads are waiting.
+   std::size_t server_threads = scheduler.capacity( chain::request_class::transaction )
+                              + scheduler.capacity( chain::request_class::read )
+                              + ( block_queue_depth ? scheduler.capacity( chain::request_class::block ) : block_threads + 1 );
+
+   asio::steady_timer stats_timer( main_ioc );
 
    try
    {
@@ -268,9 +370,22 @@ int main( int argc, char** argv )
 
       threads.emplace_back( attrs, [&]() { client_ioc.run(); } );
       threads.emplace_back( attrs, [&]() { client_ioc.run(); } );
-      for ( std::size_t i = 0; i < jobs; i++ )
+      for ( std::size_t i = 0; i < server_threads; i++ )
          threads.emplace_back( attrs, [&]() { server_ioc.run(); } );
 
+      LOG(info) << "Request threads: " << block_threads << " block, " << transaction_threads << " transaction, " << read_threads << " read";
+
+      if ( !module_dir.empty() )
+         controller.set_module_directory( module_dir );
+
+      controller.set_parallel_transactions( parallel_transactions );
+      controller.set_read_contract_cache_size( read_contract_cache_size );
+      controller.set_max_batch_size( max_batch_size );
+
+      // A parallel batch already holds a read thread, its requests run on a pool sized like the read class
+      if ( parallel_batch_requests )
+         controller.set_batch_threads( read_threads );
+
       controller.open( statedir, genesis_data, fork_algorithm, reset );
 
       LOG(info) << "Connecting AMQP client...";
@@ -289,18 +404,22 @@ int main( int argc, char** argv )
       client->rpc( util::service::mempool, m_req.SerializeAsString() ).get();
       LOG(info) << "Established connection to mempool";
 
-      chain::indexer indexer( client_ioc, controller, client );
+      chain::indexer indexer( client_ioc, controller, client, indexer_requests, indexer_queue_limit );
 
       if ( indexer.index().get() )
       {
          controller.set_client( client );
-         attach_request_handler( controller, request_handler );
+         attach_request_handler( controller, request_handler, scheduler );
+         attach_batch_request_handler( controller, request_handler, scheduler, parallel_batch_requests );
 
          LOG(info) << "Connecting AMQP request handler...";
          request_handler.connect( amqp_url );
          LOG(info) << "Established request handler connection to the AMQP server";
 
          LOG(info) << "Listening for requests over AMQP";
+         if ( request_stats_interval )
+            log_request_stats( stats_timer, scheduler, std::chrono::seconds( request_stats_interval ) );
+
          auto work = asio::make_work_guard( main_ioc );
          main_ioc.run();
       }
@@ -324,6 +443,7 @@ int main( int argc, char** argv )
       retcode = EXIT_FAILURE;
    }
 
+   scheduler.stop();
    controller.close();
 
    for ( auto& t : threads )
@@ -342,9 +462,51 @@ const std::string& version_string()
    return v_str;
 }
 
+chain::request_class classify_request( const rpc::chain::chain_request& request )
+{
+   switch( request.request_case() )
+   {
+      case rpc::chain::chain_request::RequestCase::kSubmitBlock:
+         return chain::request_class::block;
+      case rpc::chain::chain_request::RequestCase::kSubmitTransaction:
+         return chain::request_class::transaction;
+      default:
+         return chain::request_class::read;
+   }
+}
+
+void log_request_stats( asio::steady_timer& timer, const chain::request_scheduler& scheduler, std::chrono::seconds interval )
+{
+   timer.expires_after( interval );
+   timer.async_wait( [&timer, &scheduler, interval]( const system::error_code& ec )
+   {
+      if ( ec == asio::error::operation_aborted )
+         return;
+
+      for ( auto c : { chain::request_class::block, chain::request_class::transaction, chain::request_class::read } )
+      {
+         auto stats = scheduler.stats( c );
+         auto started = stats.admitted - stats.queued;
+         auto average_wait = started ? stats.total_wait.count() / started : 0;
+
+         LOG(info) << "Requests (" << chain::to_string( c ) << "): "
+                   << stats.admitted << " admitted, "
+                   << stats.rejected << " rejected, "
+                   << stats.completed << " completed, "
+                   << stats.queued << " queued, "
+                   << stats.executing << " executing, "
+                   << "wait " << average_wait << "us average, "
+                   << stats.max_wait.count() << "us max";
+      }
+
+      log_request_stats( timer, scheduler, interval );
+   } );
+}
+
 void attach_request_handler(
    chain::controller& controller,
-   mq::request_handler& reqhandler )
+   mq::request_handler& reqhandler,
+   chain::request_scheduler& scheduler )
 {
    reqhandler.add_rpc_handler(
       util::service::chain,
@@ -359,45 +521,48 @@ void attach_request_handler(
 
             try
             {
-               switch( args.request_case() )
+               scheduler.execute( classify_request( args ), [&]()
                {
-                  case rpc::chain::chain_request::RequestCase::kReserved:
-                     resp.mutable_reserved();
-                     break;
-                  case rpc::chain::chain_request::RequestCase::kSubmitBlock:
-                     *resp.mutable_submit_block() = controller.submit_block( args.submit_block() );
-                     break;
-                  case rpc::chain::chain_request::RequestCase::kSubmitTransaction:
-                     *resp.mutable_submit_transaction() = controller.submit_transaction( args.submit_transaction() );
-                     break;
-                  case rpc::chain::chain_request::RequestCase::kGetHeadInfo:
-                     *resp.mutable_get_head_info() = controller.get_head_info( args.get_head_info() );
-                     break;
-                  case rpc::chain::chain_request::RequestCase::kGetChainId:
-                     *resp.mutable_get_chain_id() = controller.get_chain_id( args.get_chain_id() );
-                     break;
-                  case rpc::chain::chain_request::RequestCase::kGetForkHeads:
-                     *resp.mutable_get_fork_heads() = controller.get_fork_heads( args.get_fork_heads() );
-                     break;
-                  case rpc::chain::chain_request::RequestCase::kReadContract:
-                     *resp.mutable_read_contract() = controller.read_contract( args.read_contract() );
-                     break;
-                  case rpc::chain::chain_request::RequestCase::kGetAccountNonce:
-                     *resp.mutable_get_account_nonce() = controller.get_account_nonce( args.get_account_nonce() );
-                     break;
-                  case rpc::chain::chain_request::RequestCase::kGetAccountRc:
-                     *resp.mutable_get_account_rc() = controller.get_account_rc( args.get_account_rc() );
-                     break;
-                  case rpc::chain::chain_request::RequestCase::kGetResourceLimits:
-                     *resp.mutable_get_resource_limits() = controller.get_resource_limits( args.get_resource_limits() );
-                     break;
-                  case rpc::chain::chain_request::RequestCase::kInvokeSystemCall:
-                     *resp.mutable_invoke_system_call() = controller.invoke_system_call( args.invoke_system_call() );
-                     break;
-                  default:
-                     resp.mutable_error()->set_message( "Error: attempted to call unknown rpc" );
-                     break;
-               }
+                  switch( args.request_case() )
+                  {
+                     case rpc::chain::chain_request::RequestCase::kReserved:
+                        resp.mutable_reserved();
+                        break;
+                     case rpc::chain::chain_request::RequestCase::kSubmitBlock:
+                        *resp.mutable_submit_block() = controller.submit_block( args.submit_block() );
+                        break;
+                     case rpc::chain::chain_request::RequestCase::kSubmitTransaction:
+                        *resp.mutable_submit_transaction() = controller.submit_transaction( args.submit_transaction() );
+                        break;
+                     case rpc::chain::chain_request::RequestCase::kGetHeadInfo:
+                        *resp.mutable_get_head_info() = controller.get_head_info( args.get_head_info() );
+                        break;
+                     case rpc::chain::chain_request::RequestCase::kGetChainId:
+                        *resp.mutable_get_chain_id() = controller.get_chain_id( args.get_chain_id() );
+                        break;
+                     case rpc::chain::chain_request::RequestCase::kGetForkHeads:
+                        *resp.mutable_get_fork_heads() = controller.get_fork_heads( args.get_fork_heads() );
+                        break;
+                     case rpc::chain::chain_request::RequestCase::kReadContract:
+                        *resp.mutable_read_contract() = controller.read_contract( args.read_contract() );
+                        break;
+                     case rpc::chain::chain_request::RequestCase::kGetAccountNonce:
+                        *resp.mutable_get_account_nonce() = controller.get_account_nonce( args.get_account_nonce() );
+                        break;
+                     case rpc::chain::chain_request::RequestCase::kGetAccountRc:
+                        *resp.mutable_get_account_rc() = controller.get_account_rc( args.get_account_rc() );
+                        break;
+                     case rpc::chain::chain_request::RequestCase::kGetResourceLimits:
+                        *resp.mutable_get_resource_limits() = controller.get_resource_limits( args.get_resource_limits() );
+                        break;
+                     case rpc::chain::chain_request::RequestCase::kInvokeSystemCall:
+                        *resp.mutable_invoke_system_call() = controller.invoke_system_call( args.invoke_system_call() );
+                        break;
+                     default:
+                        resp.mutable_error()->set_message( "Error: attempted to call unknown rpc" );
+                        break;
+                  }
+               } );
             }
             catch( const koinos::exception& e )
             {
@@ -464,7 +629,7 @@ void attach_request_handler(
          {
             rpc::chain::submit_block_request sub_block;
             sub_block.set_allocated_block( bam.release_block() );
-            controller.submit_block( sub_block );
+            scheduler.execute( chain::request_class::block, [&]() { controller.submit_block( sub_block ); } );
          }
          catch( const boost::exception& e )
          {
@@ -477,3 +642,82 @@ void attach_request_handler(
       }
    );
 }
+
+void attach_batch_request_handler(
+   chain::controller& controller,
+   mq::request_handler& reqhandler,
+   chain::request_scheduler& scheduler,
+   bool parallel )
+{
+   // A batch is a sequence of length delimited chain requests, answered with a sequence of
+   // length delimited chain responses in the same order
+   reqhandler.add_rpc_handler(
+      util::service::chain_batch,
+      [&controller, &scheduler, parallel]( const std::string& msg ) -> std::string
+      {
+         std::vector< rpc::chain::chain_request > requests;
+         std::vector< rpc::chain::chain_response > responses;
+
+         google::protobuf::io::ArrayInputStream input( msg.data(), int( msg.size() ) );
+         google::protobuf::io::CodedInputStream coded_input( &input );
+
+         bool parsed = true;
+
+         for ( ;; )
+         {
+            bool clean_eof = false;
+            rpc::chain::chain_request request;
+
+            if ( !google::protobuf::util::ParseDelimitedFromCodedStream( &request, &coded_input, &clean_eof ) )
+            {
+               parsed = clean_eof;
+               break;
+            }
+
+            requests.emplace_back( std::move( request ) );
+         }
+
+         if ( parsed )
+         {
+            LOG(debug) << "Received batch RPC with " << requests.size() << " requests";
+
+            try
+            {
+               scheduler.execute( chain::request_class::read, [&]() { responses = controller.batch( requests, parallel ); } );
+            }
+            catch( const koinos::exception& e )
+            {
+               auto error = responses.emplace_back().mutable_error();
+               error->set_message( e.what() );
+
+               auto j = e.get_json();
+               j[ "code" ] = e.get_code();
+               error->set_data( j.dump() );
+            }
+         }
+         else
+         {
+            LOG(warning) << "Received bad batch message";
+
+            auto error = responses.emplace_back().mutable_error();
+            error->set_message( "received bad message" );
+
+            nlohmann::json j;
+            j[ "code" ] = chain::internal_error;
+            error->set_data( j.dump() );
+         }
+
+         std::string r;
+
+         {
+            google::protobuf::io::StringOutputStream output( &r );
+            google::protobuf::io::CodedOutputStream coded_output( &output );
+
+            for ( const auto& response : responses )
+               google::protobuf::util::SerializeDelimitedToCodedStream( response, &coded_output );
+         }
+
+         return r;
+      }
+   );
+}
@@ -15,6 +15,7 @@ const std::string& get_get_arguments_override_wasm();
 const std::string& get_hello_wasm();
 const std::string& get_koin_wasm();
 const std::string& get_null_bytes_written_wasm();
+const std::string& get_range_read_wasm();
 const std::string& get_syscall_override_wasm();
 const std::string& get_syscall_rpc_wasm();
 
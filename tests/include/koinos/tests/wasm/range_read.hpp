@@ -0,0 +1,35 @@
+/*
+ * Hand assembled, no test contract reads a range of objects. _start calls:
+ *
+ *   space = get_contract_id()
+ *   get_next_object( { space }, "" )
+ *   put_object( { space }, get_arguments(), "\x01" )
+ *
+ * System calls are invoked by number: put_object 301, get_next_object 304,
+ * get_arguments 603, get_contract_id 604.
+ */
+unsigned char range_read_wasm[] = {
+  0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x0e, 0x02, 0x60,
+  0x06, 0x7f, 0x7f, 0x7f, 0x7f, 0x7f, 0x7f, 0x01, 0x7f, 0x60, 0x00, 0x00,
+  0x02, 0x1a, 0x01, 0x03, 0x65, 0x6e, 0x76, 0x12, 0x69, 0x6e, 0x76, 0x6f,
+  0x6b, 0x65, 0x5f, 0x73, 0x79, 0x73, 0x74, 0x65, 0x6d, 0x5f, 0x63, 0x61,
+  0x6c, 0x6c, 0x00, 0x00, 0x03, 0x02, 0x01, 0x01, 0x05, 0x03, 0x01, 0x00,
+  0x01, 0x07, 0x13, 0x02, 0x06, 0x6d, 0x65, 0x6d, 0x6f, 0x72, 0x79, 0x02,
+  0x00, 0x06, 0x5f, 0x73, 0x74, 0x61, 0x72, 0x74, 0x00, 0x01, 0x0a, 0xae,
+  0x01, 0x01, 0xab, 0x01, 0x01, 0x02, 0x7f, 0x41, 0xdc, 0x04, 0x41, 0x12,
+  0x41, 0x80, 0x01, 0x41, 0x00, 0x41, 0x00, 0x41, 0x00, 0x10, 0x00, 0x1a,
+  0x41, 0x10, 0x41, 0x0a, 0x3a, 0x00, 0x00, 0x41, 0x11, 0x41, 0x00, 0x28,
+  0x02, 0x00, 0x3a, 0x00, 0x00, 0x41, 0x12, 0x41, 0x12, 0x3a, 0x00, 0x00,
+  0x41, 0x00, 0x28, 0x02, 0x00, 0x41, 0x12, 0x6a, 0x21, 0x00, 0x41, 0xb0,
+  0x02, 0x41, 0x80, 0x08, 0x41, 0x80, 0x08, 0x41, 0x10, 0x20, 0x00, 0x41,
+  0x10, 0x6b, 0x41, 0x04, 0x10, 0x00, 0x1a, 0x41, 0xdb, 0x04, 0x20, 0x00,
+  0x41, 0x02, 0x6a, 0x41, 0x80, 0x02, 0x41, 0x00, 0x41, 0x00, 0x41, 0x08,
+  0x10, 0x00, 0x1a, 0x20, 0x00, 0x41, 0x12, 0x3a, 0x00, 0x00, 0x20, 0x00,
+  0x41, 0x08, 0x28, 0x02, 0x00, 0x3a, 0x00, 0x01, 0x20, 0x00, 0x41, 0x08,
+  0x28, 0x02, 0x00, 0x6a, 0x41, 0x02, 0x6a, 0x21, 0x01, 0x20, 0x01, 0x41,
+  0x1a, 0x3a, 0x00, 0x00, 0x20, 0x01, 0x41, 0x01, 0x3a, 0x00, 0x01, 0x20,
+  0x01, 0x41, 0x01, 0x3a, 0x00, 0x02, 0x41, 0xad, 0x02, 0x41, 0x80, 0x08,
+  0x41, 0x80, 0x08, 0x41, 0x10, 0x20, 0x01, 0x41, 0x03, 0x6a, 0x41, 0x10,
+  0x6b, 0x41, 0x04, 0x10, 0x00, 0x1a, 0x0b
+};
+unsigned int range_read_wasm_len = 259;
@@ -13,6 +13,7 @@
 #include <koinos/tests/wasm/hello.hpp>
 #include <koinos/tests/wasm/koin.hpp>
 #include <koinos/tests/wasm/null_bytes_written.hpp>
+#include <koinos/tests/wasm/range_read.hpp>
 #include <koinos/tests/wasm/syscall_override.hpp>
 #include <koinos/tests/wasm/syscall_rpc.hpp>
 
@@ -45,6 +46,7 @@ KOINOS_DEFINE_GET_WASM( get_arguments_override )
 KOINOS_DEFINE_GET_WASM( hello )
 KOINOS_DEFINE_GET_WASM( koin )
 KOINOS_DEFINE_GET_WASM( null_bytes_written )
+KOINOS_DEFINE_GET_WASM( range_read )
 KOINOS_DEFINE_GET_WASM( syscall_override )
 KOINOS_DEFINE_GET_WASM( syscall_rpc )
 KOINOS_DEFINE_GET_WASM( call_contract )
@@ -3,10 +3,15 @@
 #include <boost/filesystem/operations.hpp>
 #include <boost/filesystem/path.hpp>
 
+#include <koinos/chain/block_index.hpp>
+#include <koinos/chain/block_store_writer.hpp>
 #include <koinos/chain/constants.hpp>
 #include <koinos/chain/controller.hpp>
 #include <koinos/chain/exceptions.hpp>
 #include <koinos/chain/execution_context.hpp>
+#include <koinos/chain/indexer.hpp>
+#include <koinos/chain/read_contract_cache.hpp>
+#include <koinos/chain/request_scheduler.hpp>
 #include <koinos/chain/state.hpp>
 #include <koinos/chain/system_calls.hpp>
 #include <koinos/crypto/multihash.hpp>
@@ -20,10 +25,17 @@
 #include <koinos/chain/chain.pb.h>
 #include <koinos/chain/system_calls.pb.h>
 #include <koinos/contracts/token/token.pb.h>
+#include <koinos/rpc/block_store/block_store_rpc.pb.h>
 
+#include <google/protobuf/util/message_differencer.h>
+
+#include <atomic>
 #include <chrono>
 #include <filesystem>
+#include <future>
+#include <mutex>
 #include <sstream>
+#include <thread>
 
 using namespace koinos;
 using namespace std::string_literals;
@@ -454,6 +466,250 @@ BOOST_AUTO_TEST_CASE( block_irreversibility )
 
 } KOINOS_CATCH_LOG_AND_RETHROW(info) }
 
+BOOST_AUTO_TEST_CASE( indexer_batch_size_test )
+{ try {
+   using namespace std::chrono_literals;
+   using chain::batch_sizer;
+
+   const auto start = std::chrono::steady_clock::now();
+
+   BOOST_TEST_MESSAGE( "Test the batch size doubles up to the maximum without measurements" );
+
+   {
+      batch_sizer sizer( 4, 512'000'000, 5000ms );
+
+      BOOST_CHECK_EQUAL( sizer.next_batch_size(), batch_sizer::initial_batch_size );
+
+      uint64_t expected = batch_sizer::initial_batch_size;
+      for ( int i = 0; i < 10; i++ )
+      {
+         expected = std::min( expected * 2, batch_sizer::max_batch_size );
+         BOOST_CHECK_EQUAL( sizer.next_batch_size(), expected );
+      }
+
+      BOOST_CHECK_EQUAL( expected, batch_sizer::max_batch_size );
+   }
+
+   BOOST_TEST_MESSAGE( "Test the batch size covers a round trip at the apply rate" );
+
+   {
+      batch_sizer sizer( 4, 512'000'000, 5000ms );
+
+      BOOST_CHECK_EQUAL( sizer.next_batch_size(), 50 );
+      BOOST_CHECK_EQUAL( sizer.next_batch_size(), 100 );
+
+      // 1000 byte blocks, 1 second round trips and 100 blocks applied per second
+      sizer.update( 100, 100'000, 1s, 0, start );
+      sizer.update( 100, 100'000, 1s, 100, start + 1s );
+      BOOST_CHECK_CLOSE( sizer.average_block_bytes(), 1000.0, 0.001 );
+
+      // 100 blocks/s * 1s * 2 / 4 requests
+      BOOST_CHECK_EQUAL( sizer.next_batch_size(), 50 );
+   }
+
+   BOOST_TEST_MESSAGE( "Test the batch size shrinks as latency approaches the request timeout" );
+
+   {
+      batch_sizer sizer( 4, 512'000'000, 5000ms );
+
+      BOOST_CHECK_EQUAL( sizer.next_batch_size(), 50 );
+      BOOST_CHECK_EQUAL( sizer.next_batch_size(), 100 );
+      BOOST_CHECK_EQUAL( sizer.next_batch_size(), 200 );
+
+      sizer.update( 200, 200'000, 4s, 0, start );
+
+      // 200 * 5s / ( 2 * 4s )
+      BOOST_CHECK_EQUAL( sizer.next_batch_size(), 125 );
+   }
+
+   BOOST_TEST_MESSAGE( "Test in flight requests fit in the queue memory ceiling" );
+
+   {
+      batch_sizer sizer( 4, 400'000, 5000ms );
+
+      BOOST_CHECK_EQUAL( sizer.next_batch_size(), 50 );
+
+      sizer.update( 50, 50'000, {}, 0, start );
+
+      // 400000 bytes / ( 1000 bytes * 4 requests )
+      BOOST_CHECK_EQUAL( sizer.next_batch_size(), 100 );
+
+      // The average block size moves to 1800 bytes
+      sizer.update( 50, 250'000, {}, 0, start );
+      BOOST_CHECK_CLOSE( sizer.average_block_bytes(), 1800.0, 0.001 );
+      BOOST_CHECK_EQUAL( sizer.next_batch_size(), 55 );
+   }
+
+   BOOST_TEST_MESSAGE( "Test the batch size does not fall below the minimum" );
+
+   {
+      batch_sizer sizer( 4, 1'000, 5000ms );
+
+      BOOST_CHECK_EQUAL( sizer.next_batch_size(), 50 );
+      sizer.update( 1, 1'000, {}, 0, start );
+      BOOST_CHECK_EQUAL( sizer.next_batch_size(), batch_sizer::min_batch_size );
+   }
+} KOINOS_CATCH_LOG_AND_RETHROW(info) }
+
+BOOST_AUTO_TEST_CASE( block_store_writer_test )
+{ try {
+   BOOST_TEST_MESSAGE( "Test blocks are written to the block store in order" );
+
+   // A block store that records the blocks it adds and waits for the gate before responding
+   std::mutex mutex;
+   std::vector< std::string > written;
+   std::promise< void > open_gate;
+   auto gate = open_gate.get_future().share();
+   std::atomic< int > transport_failures = 0;
+   std::string reject_id;
+
+   auto send = [&]( const std::string& request ) -> std::string
+   {
+      gate.wait();
+
+      if ( transport_failures > 0 )
+      {
+         transport_failures--;
+         throw std::runtime_error( "request timed out" );
+      }
+
+      rpc::block_store::block_store_request req;
+      req.ParseFromString( request );
+
+      rpc::block_store::block_store_response resp;
+
+      std::lock_guard< std::mutex > lock( mutex );
+      if ( req.add_block().block_to_add().id() == reject_id )
+      {
+         resp.mutable_error()->set_message( "block rejected" );
+      }
+      else
+      {
+         written.push_back( req.add_block().block_to_add().id() );
+         resp.mutable_add_block();
+      }
+
+      return resp.SerializeAsString();
+   };
+
+   auto make_block = []( uint64_t height )
+   {
+      protocol::block block;
+      block.set_id( "block" + std::to_string( height ) );
+      block.mutable_header()->set_height( height );
+      return block;
+   };
+
+   {
+      chain::block_store_writer writer( send, 2 );
+
+      BOOST_REQUIRE( writer.add_block( make_block( 1 ), {}, std::chrono::milliseconds( 0 ) ) );
+      BOOST_REQUIRE( writer.add_block( make_block( 2 ), {}, std::chrono::milliseconds( 0 ) ) );
+      BOOST_CHECK( !writer.acknowledged( "block1" ) );
+
+      BOOST_TEST_MESSAGE( "Test the backlog of unacknowledged blocks is bounded" );
+
+      BOOST_CHECK( !writer.add_block( make_block( 3 ), {}, std::chrono::milliseconds( 10 ) ) );
+
+      BOOST_TEST_MESSAGE( "Test transport failures are retried" );
+
+      transport_failures = 1;
+      open_gate.set_value();
+
+      BOOST_REQUIRE( writer.flush( std::chrono::seconds( 5 ) ) );
+      BOOST_CHECK( writer.acknowledged( "block1" ) );
+      BOOST_CHECK( writer.acknowledged( "block2" ) );
+      BOOST_CHECK_EQUAL( transport_failures.load(), 0 );
+
+      BOOST_REQUIRE( writer.add_block( make_block( 3 ), {}, std::chrono::milliseconds( 0 ) ) );
+      BOOST_REQUIRE( writer.flush( std::chrono::seconds( 5 ) ) );
+
+      std::lock_guard< std::mutex > lock( mutex );
+      BOOST_REQUIRE( written == std::vector< std::string >( { "block1", "block2", "block3" } ) );
+   }
+
+   BOOST_TEST_MESSAGE( "Test a rejected block fails the writer" );
+
+   {
+      written.clear();
+      reject_id = "block2";
+
+      chain::block_store_writer writer( send, 8 );
+
+      BOOST_REQUIRE( writer.add_block( make_block( 1 ), {}, std::chrono::milliseconds( 0 ) ) );
+      BOOST_REQUIRE( writer.add_block( make_block( 2 ), {}, std::chrono::milliseconds( 0 ) ) );
+      BOOST_REQUIRE( writer.add_block( make_block( 3 ), {}, std::chrono::milliseconds( 0 ) ) );
+
+      BOOST_CHECK( !writer.flush( std::chrono::seconds( 5 ) ) );
+      BOOST_REQUIRE( writer.error() );
+      BOOST_CHECK_EQUAL( *writer.error(), "block rejected" );
+
+      BOOST_CHECK( writer.acknowledged( "block1" ) );
+      BOOST_CHECK( !writer.acknowledged( "block2" ) );
+      BOOST_CHECK( !writer.acknowledged( "block3" ) );
+
+      BOOST_CHECK_THROW( writer.add_block( make_block( 4 ), {}, std::chrono::milliseconds( 0 ) ), chain::rpc_failure_exception );
+
+      std::lock_guard< std::mutex > lock( mutex );
+      BOOST_REQUIRE( written == std::vector< std::string >( { "block1" } ) );
+   }
+} KOINOS_CATCH_LOG_AND_RETHROW(info) }
+
+BOOST_AUTO_TEST_CASE( block_store_lib_test )
+{ try {
+   BOOST_TEST_MESSAGE( "Test LIB does not advance past blocks the block store has not acknowledged" );
+
+   std::promise< void > open_gate;
+   auto gate = open_gate.get_future().share();
+
+   auto writer = std::make_unique< chain::block_store_writer >( [&]( const std::string& ) -> std::string
+   {
+      gate.wait();
+
+      rpc::block_store::block_store_response resp;
+      resp.mutable_add_block();
+      return resp.SerializeAsString();
+   } );
+
+   // The controller owns the writer until it is replaced at the end of the test
+   auto* gated_writer = writer.get();
+   _controller.set_block_store_writer( std::move( writer ) );
+
+   auto submit_next_block = [&]()
+   {
+      auto head_info = _controller.get_head_info();
+
+      rpc::chain::submit_block_request block_req;
+      block_req.mutable_block()->mutable_header()->set_timestamp( head_info.head_block_time() + 1 );
+      block_req.mutable_block()->mutable_header()->set_height( head_info.head_topology().height() + 1 );
+      block_req.mutable_block()->mutable_header()->set_previous( head_info.head_topology().id() );
+      block_req.mutable_block()->mutable_header()->set_previous_state_merkle_root( head_info.head_state_merkle_root() );
+
+      set_block_merkle_roots( *block_req.mutable_block(), koinos::crypto::multicodec::sha2_256 );
+      block_req.mutable_block()->set_id( util::converter::as< std::string >( crypto::hash( koinos::crypto::multicodec::sha2_256, block_req.block().header() ) ) );
+      sign_block( *block_req.mutable_block(), _block_signing_private_key );
+
+      _controller.submit_block( block_req );
+   };
+
+   for ( uint64_t i = 0; i < chain::default_irreversible_threshold + 3; i++ )
+      submit_next_block();
+
+   BOOST_CHECK_EQUAL( _controller.get_fork_heads().last_irreversible_block().height(), 0 );
+
+   BOOST_TEST_MESSAGE( "Test LIB advances once the blocks are acknowledged" );
+
+   open_gate.set_value();
+   BOOST_REQUIRE( gated_writer->flush( std::chrono::seconds( 5 ) ) );
+
+   submit_next_block();
+
+   auto head_info = _controller.get_head_info();
+   BOOST_CHECK_EQUAL( _controller.get_fork_heads().last_irreversible_block().height(), head_info.head_topology().height() - chain::default_irreversible_threshold );
+
+   _controller.set_block_store_writer( {} );
+} KOINOS_CATCH_LOG_AND_RETHROW(info) }
+
 BOOST_AUTO_TEST_CASE( fork_heads )
 { try {
    BOOST_TEST_MESSAGE( "Setting up forks and checking heads" );
@@ -555,6 +811,213 @@ BOOST_AUTO_TEST_CASE( fork_heads )
 
 } KOINOS_CATCH_LOG_AND_RETHROW(info) }
 
+BOOST_AUTO_TEST_CASE( block_index_test )
+{ try {
+   BOOST_TEST_MESSAGE( "Test fork heads are tracked as blocks are added" );
+
+   chain::block_index index;
+   index.reset( chain::indexed_block { .id = "root", .height = 0, .timestamp = 100 } );
+
+   BOOST_REQUIRE_EQUAL( index.fork_heads().size(), 1 );
+   BOOST_CHECK_EQUAL( index.fork_heads()[ 0 ].id, "root" );
+
+   index.add( chain::indexed_block { .id = "a1", .previous = "root", .height = 1, .timestamp = 101 } );
+   index.add( chain::indexed_block { .id = "a2", .previous = "a1", .height = 2, .timestamp = 102 } );
+   index.add( chain::indexed_block { .id = "b2", .previous = "a1", .height = 2, .timestamp = 103 } );
+   index.add( chain::indexed_block { .id = "c1", .previous = "root", .height = 1, .timestamp = 104 } );
+   index.add( chain::indexed_block { .id = "orphan", .previous = "unknown", .height = 5, .timestamp = 105 } );
+
+   BOOST_CHECK_EQUAL( index.size(), 5 );
+   BOOST_CHECK( !index.get( "orphan" ) );
+   BOOST_REQUIRE( index.get( "b2" ) );
+   BOOST_CHECK_EQUAL( index.get( "b2" )->timestamp, 103 );
+
+   auto heads = index.fork_heads( "b2" );
+   BOOST_REQUIRE_EQUAL( heads.size(), 3 );
+   BOOST_CHECK_EQUAL( heads[ 0 ].id, "b2" );
+   BOOST_CHECK_EQUAL( heads[ 1 ].id, "a2" );
+   BOOST_CHECK_EQUAL( heads[ 2 ].id, "c1" );
+
+   heads = index.fork_heads( "a2" );
+   BOOST_CHECK_EQUAL( heads[ 0 ].id, "a2" );
+
+   BOOST_TEST_MESSAGE( "Test advancing the root prunes other forks" );
+
+   index.set_root( "a1" );
+
+   BOOST_CHECK_EQUAL( index.root().id, "a1" );
+   BOOST_CHECK_EQUAL( index.size(), 3 );
+   BOOST_CHECK( !index.get( "root" ) );
+   BOOST_CHECK( !index.get( "c1" ) );
+   BOOST_CHECK_EQUAL( index.fork_heads().size(), 2 );
+
+   index.set_root( "a2" );
+
+   BOOST_CHECK_EQUAL( index.size(), 1 );
+   BOOST_REQUIRE_EQUAL( index.fork_heads().size(), 1 );
+   BOOST_CHECK_EQUAL( index.fork_heads()[ 0 ].id, "a2" );
+} KOINOS_CATCH_LOG_AND_RETHROW(info) }
+
+BOOST_AUTO_TEST_CASE( read_contract_cache_test )
+{ try {
+   BOOST_TEST_MESSAGE( "Test read contract responses are cached for the head block" );
+
+   chain::read_contract_cache cache( 2 );
+   cache.set_head( "head1" );
+
+   std::atomic< uint64_t > executions = 0;
+
+   auto execute = [&]( const std::string& result )
+   {
+      return [&, result]()
+      {
+         executions++;
+         rpc::chain::read_contract_response resp;
+         resp.set_result( result );
+         *resp.add_logs() = "log";
+         return resp;
+      };
+   };
+
+   rpc::chain::read_contract_request request;
+   request.set_contract_id( "contract" );
+   request.set_entry_point( 1 );
+   request.set_args( "args" );
+
+   BOOST_CHECK_EQUAL( cache.get( "head1", request, execute( "a" ) ).result(), "a" );
+   auto resp = cache.get( "head1", request, execute( "b" ) );
+   BOOST_CHECK_EQUAL( resp.result(), "a" );
+   BOOST_REQUIRE_EQUAL( resp.logs_size(), 1 );
+   BOOST_CHECK_EQUAL( executions.load(), 1 );
+
+   auto other_request = request;
+   other_request.set_args( "other" );
+   BOOST_CHECK_EQUAL( cache.get( "head1", other_request, execute( "c" ) ).result(), "c" );
+
+   other_request = request;
+   other_request.set_entry_point( 2 );
+   BOOST_CHECK_EQUAL( cache.get( "head1", other_request, execute( "d" ) ).result(), "d" );
+   BOOST_CHECK_EQUAL( executions.load(), 3 );
+   BOOST_CHECK_EQUAL( cache.stats().entries, 2 );
+
+   BOOST_TEST_MESSAGE( "Test reads against another head are not cached" );
+
+   BOOST_CHECK_EQUAL( cache.get( "head0", request, execute( "e" ) ).result(), "e" );
+   BOOST_CHECK_EQUAL( cache.get( "head0", request, execute( "f" ) ).result(), "f" );
+
+   cache.set_head( "head2" );
+   BOOST_CHECK_EQUAL( cache.stats().entries, 0 );
+   BOOST_CHECK_EQUAL( cache.get( "head2", request, execute( "g" ) ).result(), "g" );
+   BOOST_CHECK_EQUAL( cache.get( "head2", request, execute( "h" ) ).result(), "g" );
+
+   BOOST_TEST_MESSAGE( "Test failed reads are not cached" );
+
+   request.set_args( "fail" );
+   BOOST_CHECK_THROW( cache.get( "head2", request, [&]() -> rpc::chain::read_contract_response { throw std::runtime_error( "failed" ); } ), std::runtime_error );
+   BOOST_CHECK_EQUAL( cache.get( "head2", request, execute( "i" ) ).result(), "i" );
+
+   BOOST_TEST_MESSAGE( "Test concurrent identical misses execute once" );
+
+   request.set_args( "concurrent" );
+   executions = 0;
+
+   std::promise< void > release;
+   auto released = release.get_future().share();
+   auto slow = [&]()
+   {
+      executions++;
+      released.wait();
+      rpc::chain::read_contract_response resp;
+      resp.set_result( "slow" );
+      return resp;
+   };
+
+   std::vector< std::future< rpc::chain::read_contract_response > > reads;
+   reads.emplace_back( std::async( std::launch::async, [&]() { return cache.get( "head2", request, slow ); } ) );
+
+   while ( executions == 0 )
+      std::this_thread::yield();
+
+   for ( std::size_t i = 0; i < 4; i++ )
+      reads.emplace_back( std::async( std::launch::async, [&]() { return cache.get( "head2", request, slow ); } ) );
+
+   while ( cache.stats().shared < 4 )
+      std::this_thread::yield();
+
+   release.set_value();
+
+   for ( auto& read : reads )
+      BOOST_CHECK_EQUAL( read.get().result(), "slow" );
+
+   BOOST_CHECK_EQUAL( executions.load(), 1 );
+} KOINOS_CATCH_LOG_AND_RETHROW(info) }
+
+BOOST_AUTO_TEST_CASE( request_scheduler_test )
+{ try {
+   BOOST_TEST_MESSAGE( "Test blocks are not delayed by queued reads" );
+
+   chain::request_scheduler scheduler(
+      chain::request_class_config { .threads = 1 },
+      chain::request_class_config { .threads = 1, .max_queue_depth = 1 },
+      chain::request_class_config { .threads = 1, .max_queue_depth = 1 }
+   );
+
+   BOOST_CHECK_EQUAL( scheduler.capacity( chain::request_class::read ), 2 );
+
+   std::promise< void > release;
+   auto released = release.get_future().share();
+   std::atomic< uint64_t > reads = 0;
+
+   auto blocking_read = [&]()
+   {
+      scheduler.execute( chain::request_class::read, [&]() { released.wait(); reads++; } );
+   };
+
+   auto wait_for = [&]( auto predicate )
+   {
+      while ( !predicate( scheduler.stats( chain::request_class::read ) ) )
+         std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+   };
+
+   std::thread executing_read( blocking_read );
+   wait_for( []( const chain::request_class_stats& s ) { return s.executing == 1; } );
+
+   std::thread queued_read( blocking_read );
+   wait_for( []( const chain::request_class_stats& s ) { return s.queued == 1; } );
+
+   bool block_applied = false;
+   scheduler.execute( chain::request_class::block, [&]() { block_applied = true; } );
+   BOOST_CHECK( block_applied );
+
+   BOOST_TEST_MESSAGE( "Test reads beyond the queue depth are rejected" );
+
+   BOOST_CHECK_THROW( scheduler.execute( chain::request_class::read, [&]() { reads++; } ), chain::request_rejected_exception );
+
+   auto stats = scheduler.stats( chain::request_class::read );
+   BOOST_CHECK_EQUAL( stats.admitted, 2 );
+   BOOST_CHECK_EQUAL( stats.rejected, 1 );
+
+   release.set_value();
+   executing_read.join();
+   queued_read.join();
+
+   BOOST_CHECK_EQUAL( reads.load(), 2 );
+
+   stats = scheduler.stats( chain::request_class::read );
+   BOOST_CHECK_EQUAL( stats.completed, 2 );
+   BOOST_CHECK_EQUAL( stats.queued, 0 );
+   BOOST_CHECK_EQUAL( stats.executing, 0 );
+   BOOST_CHECK( stats.max_wait > std::chrono::microseconds::zero() );
+
+   BOOST_TEST_MESSAGE( "Test exceptions are rethrown to the caller" );
+
+   BOOST_CHECK_THROW( scheduler.execute( chain::request_class::transaction, []() { throw std::runtime_error( "failed" ); } ), std::runtime_error );
+   BOOST_CHECK_EQUAL( scheduler.stats( chain::request_class::transaction ).completed, 1 );
+
+   scheduler.stop();
+   BOOST_CHECK_THROW( scheduler.execute( chain::request_class::block, []() {} ), chain::request_rejected_exception );
+} KOINOS_CATCH_LOG_AND_RETHROW(info) }
+
 BOOST_AUTO_TEST_CASE( read_contract_tests )
 { try {
    BOOST_TEST_MESSAGE( "Upload contracts" );
@@ -642,6 +1105,126 @@ BOOST_AUTO_TEST_CASE( read_contract_tests )
    KOINOS_REQUIRE_THROW( _controller.read_contract( request ), chain::read_only_context );
 } KOINOS_CATCH_LOG_AND_RETHROW(info) }
 
+BOOST_AUTO_TEST_CASE( pinned_read_test )
+{ try {
+   BOOST_TEST_MESSAGE( "Test blocks are applied and LIB advances while reads are pinned" );
+
+   auto submit_next_block = [&]()
+   {
+      auto head_info = _controller.get_head_info();
+
+      rpc::chain::submit_block_request block_req;
+      block_req.mutable_block()->mutable_header()->set_timestamp( head_info.head_block_time() + 1 );
+      block_req.mutable_block()->mutable_header()->set_height( head_info.head_topology().height() + 1 );
+      block_req.mutable_block()->mutable_header()->set_previous( head_info.head_topology().id() );
+      block_req.mutable_block()->mutable_header()->set_previous_state_merkle_root( head_info.head_state_merkle_root() );
+
+      set_block_merkle_roots( *block_req.mutable_block(), koinos::crypto::multicodec::sha2_256 );
+      block_req.mutable_block()->set_id( util::converter::as< std::string >( crypto::hash( koinos::crypto::multicodec::sha2_256, block_req.block().header() ) ) );
+      sign_block( *block_req.mutable_block(), _block_signing_private_key );
+
+      _controller.submit_block( block_req );
+   };
+
+   std::atomic< bool > reading = true;
+   std::atomic< uint64_t > reads = 0;
+
+   rpc::chain::get_account_nonce_request nonce_request;
+   nonce_request.set_account( _alice_address );
+
+   std::vector< std::thread > readers;
+   for ( int i = 0; i < 4; i++ )
+   {
+      readers.emplace_back( [&]()
+      {
+         while ( reading )
+         {
+            _controller.get_account_nonce( nonce_request );
+            _controller.get_resource_limits( {} );
+            reads++;
+         }
+      } );
+   }
+
+   for ( uint64_t i = 0; i < chain::default_irreversible_threshold * 2; i++ )
+      submit_next_block();
+
+   reading = false;
+   for ( auto& reader : readers )
+      reader.join();
+
+   BOOST_CHECK( reads.load() > 0 );
+
+   auto head_height = _controller.get_head_info().head_topology().height();
+   BOOST_CHECK_EQUAL( head_height, chain::default_irreversible_threshold * 2 );
+   BOOST_CHECK( _controller.get_fork_heads().last_irreversible_block().height() > 0 );
+
+   BOOST_TEST_MESSAGE( "Test deferred commits complete once no reads are pinned" );
+
+   submit_next_block();
+
+   auto head_info = _controller.get_head_info();
+   BOOST_CHECK_EQUAL( _controller.get_fork_heads().last_irreversible_block().height(), head_info.head_topology().height() - chain::default_irreversible_threshold );
+} KOINOS_CATCH_LOG_AND_RETHROW(info) }
+
+BOOST_AUTO_TEST_CASE( batch_test )
+{ try {
+   BOOST_TEST_MESSAGE( "Test batched requests match their individual responses" );
+
+   std::vector< rpc::chain::chain_request > requests;
+   requests.emplace_back().mutable_get_head_info();
+   requests.emplace_back().mutable_get_chain_id();
+   requests.emplace_back().mutable_get_resource_limits();
+
+   auto nonce_request = requests.emplace_back().mutable_get_account_nonce();
+   nonce_request->set_account( _alice_address );
+
+   auto syscall_request = requests.emplace_back().mutable_invoke_system_call();
+   syscall_request->set_id( chain::system_call_id::get_contract_id );
+
+   requests.emplace_back().mutable_submit_block();
+
+   _controller.set_batch_threads( 2 );
+
+   for ( bool parallel : { false, true } )
+   {
+      auto responses = _controller.batch( requests, parallel );
+      BOOST_REQUIRE_EQUAL( responses.size(), requests.size() );
+
+      BOOST_REQUIRE( responses[0].has_get_head_info() );
+      BOOST_CHECK_EQUAL( responses[0].get_head_info().SerializeAsString(), _controller.get_head_info().SerializeAsString() );
+
+      BOOST_REQUIRE( responses[1].has_get_chain_id() );
+      BOOST_CHECK_EQUAL( responses[1].get_chain_id().chain_id(), _controller.get_chain_id().chain_id() );
+
+      BOOST_REQUIRE( responses[2].has_get_resource_limits() );
+      BOOST_CHECK_EQUAL( responses[2].get_resource_limits().SerializeAsString(), _controller.get_resource_limits( {} ).SerializeAsString() );
+
+      BOOST_REQUIRE( responses[3].has_get_account_nonce() );
+      BOOST_CHECK_EQUAL( responses[3].get_account_nonce().nonce(), _controller.get_account_nonce( requests[3].get_account_nonce() ).nonce() );
+
+      BOOST_REQUIRE( responses[4].has_invoke_system_call() );
+      koinos::chain::get_contract_id_result contract_id_result;
+      contract_id_result.ParseFromString( responses[4].invoke_system_call().value() );
+      BOOST_CHECK_EQUAL( contract_id_result.value(), koinos::chain::constants::system );
+
+      BOOST_TEST_MESSAGE( "Test requests that cannot be batched are rejected" );
+
+      BOOST_CHECK( responses[5].has_error() );
+   }
+
+   BOOST_CHECK( _controller.batch( {} ).empty() );
+
+   BOOST_TEST_MESSAGE( "Test batches larger than the maximum batch size are rejected" );
+
+   _controller.set_max_batch_size( requests.size() );
+   BOOST_CHECK_EQUAL( _controller.batch( requests, true ).size(), requests.size() );
+
+   _controller.set_max_batch_size( requests.size() - 1 );
+   BOOST_CHECK_THROW( _controller.batch( requests ), chain::request_rejected_exception );
+   BOOST_CHECK_THROW( _controller.batch( requests, true ), chain::request_rejected_exception );
+} KOINOS_CATCH_LOG_AND_RETHROW(info) }
+
 BOOST_AUTO_TEST_CASE( transaction_reversion_test )
 { try {
    BOOST_TEST_MESSAGE( "Upload KOIN contract and attempt to mint to Alice" );
@@ -986,6 +1569,200 @@ BOOST_AUTO_TEST_CASE( receipt_test )
 
 } KOINOS_CATCH_LOG_AND_RETHROW(info) }
 
+BOOST_AUTO_TEST_CASE( parallel_transactions_test )
+{ try {
+   BOOST_TEST_MESSAGE( "Test blocks applied in parallel match serial application" );
+
+   auto parallel_dir = std::filesystem::temp_directory_path() / boost::filesystem::unique_path().string();
+   std::filesystem::create_directory( parallel_dir );
+
+   chain::controller parallel_controller( 10'000'000, 64'000 );
+   parallel_controller.set_parallel_transactions( true );
+   parallel_controller.open( parallel_dir, _genesis_data, chain::fork_resolution_algorithm::fifo, false );
+
+   auto make_key = []( const std::string& seed )
+   {
+      return crypto::private_key::regenerate( crypto::hash( crypto::multicodec::sha2_256, seed ) );
+   };
+
+   auto koin_key    = make_key( "koin" );
+   auto range_key   = make_key( "range_read" );
+   auto forever_key = make_key( "forever" );
+   auto alice_key   = make_key( "alice" );
+   auto bob_key     = make_key( "bob" );
+   auto carol_key   = make_key( "carol" );
+   auto dave_key    = make_key( "dave" );
+
+   auto koin_id    = util::converter::as< std::string >( koin_key.get_public_key().to_address_bytes() );
+   auto range_id   = util::converter::as< std::string >( range_key.get_public_key().to_address_bytes() );
+   auto forever_id = util::converter::as< std::string >( forever_key.get_public_key().to_address_bytes() );
+
+   std::map< std::string, uint64_t > nonces;
+
+   auto make_transaction = [&]( crypto::private_key& key, std::vector< protocol::operation > operations, uint64_t rc_limit = 10'000'000 )
+   {
+      protocol::transaction trx;
+      for ( auto& op : operations )
+         *trx.add_operations() = std::move( op );
+
+      koinos::chain::value_type nonce_value;
+      nonce_value.set_uint64_value( ++nonces[ key.get_public_key().to_address_bytes() ] );
+
+      trx.mutable_header()->set_rc_limit( rc_limit );
+      trx.mutable_header()->set_chain_id( _controller.get_chain_id().chain_id() );
+      trx.mutable_header()->set_nonce( util::converter::as< std::string >( nonce_value ) );
+      set_transaction_merkle_roots( trx, koinos::crypto::multicodec::sha2_256 );
+      sign_transaction( trx, key );
+
+      return trx;
+   };
+
+   auto upload = [&]( const std::string& contract_id, const std::string& bytecode )
+   {
+      protocol::operation op;
+      op.mutable_upload_contract()->set_contract_id( contract_id );
+      op.mutable_upload_contract()->set_bytecode( bytecode );
+      return op;
+   };
+
+   auto call = [&]( const std::string& contract_id, uint32_t entry_point, const std::string& args )
+   {
+      protocol::operation op;
+      op.mutable_call_contract()->set_contract_id( contract_id );
+      op.mutable_call_contract()->set_entry_point( entry_point );
+      op.mutable_call_contract()->set_args( args );
+      return op;
+   };
+
+   auto transfer = [&]( crypto::private_key& from, crypto::private_key& to )
+   {
+      koinos::contracts::token::transfer_arguments args;
+      args.set_from( from.get_public_key().to_address_bytes() );
+      args.set_to( to.get_public_key().to_address_bytes() );
+      args.set_value( 0 );
+      return make_transaction( from, { call( koin_id, token_entry::transfer, args.SerializeAsString() ) } );
+   };
+
+   // Submits the block to both controllers and requires identical receipts and state
+   auto apply_block = [&]( const std::vector< protocol::transaction >& transactions )
+   {
+      auto head_info = _controller.get_head_info();
+
+      rpc::chain::submit_block_request block_req;
+      block_req.mutable_block()->mutable_header()->set_timestamp( head_info.head_block_time() + 1 );
+      block_req.mutable_block()->mutable_header()->set_height( head_info.head_topology().height() + 1 );
+      block_req.mutable_block()->mutable_header()->set_previous( head_info.head_topology().id() );
+      block_req.mutable_block()->mutable_header()->set_previous_state_merkle_root( head_info.head_state_merkle_root() );
+
+      for ( const auto& trx : transactions )
+         *block_req.mutable_block()->add_transactions() = trx;
+
+      set_block_merkle_roots( *block_req.mutable_block(), koinos::crypto::multicodec::sha2_256 );
+      block_req.mutable_block()->set_id( util::converter::as< std::string >( crypto::hash( koinos::crypto::multicodec::sha2_256, block_req.block().header() ) ) );
+      sign_block( *block_req.mutable_block(), _block_signing_private_key );
+
+      auto serial   = _controller.submit_block( block_req );
+      auto parallel = parallel_controller.submit_block( block_req );
+
+      BOOST_REQUIRE_EQUAL( std::size_t( serial.receipt().transaction_receipts_size() ), transactions.size() );
+      BOOST_CHECK_EQUAL( serial.receipt().state_merkle_root(), parallel.receipt().state_merkle_root() );
+      BOOST_CHECK_EQUAL( serial.receipt().compute_bandwidth_used(), parallel.receipt().compute_bandwidth_used() );
+      BOOST_CHECK_EQUAL( serial.receipt().network_bandwidth_used(), parallel.receipt().network_bandwidth_used() );
+      BOOST_CHECK_EQUAL( serial.receipt().disk_storage_used(), parallel.receipt().disk_storage_used() );
+      BOOST_CHECK( google::protobuf::util::MessageDifferencer::Equals( serial.receipt(), parallel.receipt() ) );
+      BOOST_CHECK_EQUAL( _controller.get_head_info().head_state_merkle_root(), parallel_controller.get_head_info().head_state_merkle_root() );
+
+      return serial.receipt();
+   };
+
+   BOOST_TEST_MESSAGE( "Upload the KOIN, range read and forever contracts" );
+
+   protocol::operation set_system_op;
+   set_system_op.mutable_set_system_contract()->set_contract_id( koin_id );
+   set_system_op.mutable_set_system_contract()->set_system_contract( true );
+
+   auto koin_trx = make_transaction( koin_key, { upload( koin_id, get_koin_wasm() ), set_system_op } );
+   add_signature( koin_trx, _block_signing_private_key );
+
+   auto receipt = apply_block( {
+      koin_trx,
+      make_transaction( range_key, { upload( range_id, get_range_read_wasm() ) } ),
+      make_transaction( forever_key, { upload( forever_id, get_forever_wasm() ) } )
+   } );
+
+   for ( const auto& trx_receipt : receipt.transaction_receipts() )
+      BOOST_REQUIRE( !trx_receipt.reverted() );
+
+   BOOST_TEST_MESSAGE( "Test independent transfers" );
+
+   receipt = apply_block( { transfer( alice_key, bob_key ), transfer( carol_key, dave_key ) } );
+
+   for ( const auto& trx_receipt : receipt.transaction_receipts() )
+   {
+      BOOST_CHECK( !trx_receipt.reverted() );
+      BOOST_CHECK_EQUAL( trx_receipt.events_size(), 1 );
+   }
+
+   BOOST_TEST_MESSAGE( "Test transactions with the same payer" );
+
+   receipt = apply_block( { transfer( alice_key, bob_key ), transfer( alice_key, carol_key ), transfer( alice_key, dave_key ) } );
+
+   for ( const auto& trx_receipt : receipt.transaction_receipts() )
+      BOOST_CHECK( !trx_receipt.reverted() );
+
+   BOOST_TEST_MESSAGE( "Test a transaction reading an object written earlier in the block" );
+
+   receipt = apply_block( { transfer( carol_key, alice_key ), transfer( alice_key, dave_key ) } );
+
+   BOOST_CHECK( !receipt.transaction_receipts( 0 ).reverted() );
+   BOOST_CHECK( !receipt.transaction_receipts( 1 ).reverted() );
+
+   BOOST_TEST_MESSAGE( "Test a reverted transaction" );
+
+   koinos::contracts::token::mint_arguments mint_args;
+   mint_args.set_to( dave_key.get_public_key().to_address_bytes() );
+   mint_args.set_value( 100 );
+
+   receipt = apply_block( {
+      make_transaction( dave_key, { call( koin_id, token_entry::mint, mint_args.SerializeAsString() ) } ),
+      transfer( bob_key, carol_key )
+   } );
+
+   BOOST_CHECK( receipt.transaction_receipts( 0 ).reverted() );
+   BOOST_CHECK( !receipt.transaction_receipts( 1 ).reverted() );
+
+   BOOST_TEST_MESSAGE( "Test a block that nearly exhausts the block compute limit" );
+
+   // Each call runs until the payer's rc is exhausted, the block compute limit is 100'000'000
+   std::vector< protocol::transaction > forever_transactions;
+   for ( int i = 0; i < 10; i++ )
+   {
+      auto payer_key = make_key( "payer " + std::to_string( i ) );
+      forever_transactions.push_back( make_transaction( payer_key, { call( forever_id, 0, "" ) }, i < 9 ? 10'000'000 : 8'000'000 ) );
+   }
+
+   receipt = apply_block( forever_transactions );
+
+   for ( const auto& trx_receipt : receipt.transaction_receipts() )
+      BOOST_CHECK( trx_receipt.reverted() );
+
+   BOOST_CHECK_GT( receipt.compute_bandwidth_used(), 90'000'000 );
+
+   BOOST_TEST_MESSAGE( "Test a range read of objects written earlier in the block" );
+
+   receipt = apply_block( {
+      make_transaction( alice_key, { call( range_id, 0, "a" ) } ),
+      make_transaction( bob_key, { call( range_id, 0, "b" ) } ),
+      transfer( carol_key, dave_key )
+   } );
+
+   for ( const auto& trx_receipt : receipt.transaction_receipts() )
+      BOOST_CHECK( !trx_receipt.reverted() );
+
+   parallel_controller.close();
+   std::filesystem::remove_all( parallel_dir );
+} KOINOS_CATCH_LOG_AND_RETHROW(info) }
+
 BOOST_AUTO_TEST_CASE( system_call_override_test )
 { try {
    BOOST_TEST_MESSAGE( "Upload a contract that calls the log system call" );
@@ -1475,4 +2252,45 @@ BOOST_AUTO_TEST_CASE( invoke_system_call_test )
    }
 
 } KOINOS_CATCH_LOG_AND_RETHROW(info) }
+
+BOOST_AUTO_TEST_CASE( prepared_block_test )
+{ try {
+   using namespace koinos;
+
+   BOOST_TEST_MESSAGE( "Error when preparing an invalid block" );
+
+   BOOST_CHECK_THROW( _controller.prepare_block( protocol::block() ), chain::missing_required_arguments_exception );
+
+   BOOST_TEST_MESSAGE( "Test submitting a prepared block" );
+
+   protocol::block block;
+
+   auto duration = std::chrono::system_clock::now().time_since_epoch();
+   block.mutable_header()->set_timestamp( std::chrono::duration_cast< std::chrono::milliseconds >( duration ).count() );
+   block.mutable_header()->set_height( 1 );
+   block.mutable_header()->set_previous_state_merkle_root( _controller.get_head_info().head_state_merkle_root() );
+   block.mutable_header()->set_previous( util::converter::as< std::string >( crypto::multihash::zero( crypto::multicodec::sha2_256 ) ) );
+
+   set_block_merkle_roots( block, crypto::multicodec::sha2_256 );
+   block.set_id( util::converter::as< std::string >( koinos::crypto::hash( crypto::multicodec::sha2_256, block.header() ) ) );
+   sign_block( block, _block_signing_private_key );
+
+   auto prepared = _controller.prepare_block( protocol::block( block ) );
+
+   BOOST_REQUIRE( prepared->signatures );
+   BOOST_CHECK_EQUAL( prepared->signatures->size(), 1 );
+   BOOST_CHECK( prepared->block.id() == block.id() );
+
+   BOOST_REQUIRE( prepared->serialized.describes( prepared->block ) );
+   BOOST_CHECK( !prepared->serialized.describes( block ) );
+   BOOST_CHECK( prepared->serialized.header == util::converter::as< std::string >( block.header() ) );
+   BOOST_CHECK( prepared->serialized.block == util::converter::as< std::string >( block ) );
+   BOOST_CHECK_EQUAL( prepared->serialized.transactions.size(), block.transactions_size() );
+
+   auto block_resp = _controller.submit_block( *prepared );
+
+   BOOST_CHECK_EQUAL( block_resp.receipt().height(), 1 );
+   BOOST_CHECK( _controller.get_head_info().head_topology().id() == block.id() );
+} KOINOS_CATCH_LOG_AND_RETHROW(info) }
+
 BOOST_AUTO_TEST_SUITE_END()
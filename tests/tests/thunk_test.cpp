@@ -2,6 +2,7 @@
 #include <cmath>
 #include <filesystem>
 #include <fstream>
+#include <limits>
 #include <numeric>
 #include <random>
 #include <type_traits>
@@ -20,6 +21,9 @@
 #include <koinos/chain/constants.hpp>
 #include <koinos/chain/exceptions.hpp>
 #include <koinos/chain/host_api.hpp>
+#include <koinos/chain/merkle.hpp>
+#include <koinos/chain/parallel_executor.hpp>
+#include <koinos/chain/resource_meter.hpp>
 #include <koinos/chain/thunk_dispatcher.hpp>
 #include <koinos/chain/session.hpp>
 #include <koinos/chain/state.hpp>
@@ -29,6 +33,8 @@
 
 #include <koinos/vm_manager/exceptions.hpp>
 #include <koinos/vm_manager/fizzy/exceptions.hpp>
+#include <koinos/vm_manager/fizzy/module_cache.hpp>
+#include <koinos/vm_manager/fizzy/module_store.hpp>
 
 #include <koinos/contracts/token/token.pb.h>
 
@@ -2759,4 +2765,577 @@ BOOST_AUTO_TEST_CASE( null_bytes_written_test )
    BOOST_CHECK_THROW( koinos::chain::system_call::apply_call_contract_operation( ctx, op2 ), koinos::vm_manager::fizzy::wasm_memory_exception );
 } KOINOS_CATCH_LOG_AND_RETHROW(info) }
 
+BOOST_AUTO_TEST_CASE( signature_cache_test )
+{ try {
+   BOOST_TEST_MESSAGE( "Test recover_public_key consumes pre-recovered keys" );
+
+   auto foo_key = crypto::private_key::regenerate( crypto::hash( crypto::multicodec::sha2_256, "foo"s ) );
+   auto bar_key = crypto::private_key::regenerate( crypto::hash( crypto::multicodec::sha2_256, "bar"s ) );
+
+   auto digest = util::converter::as< std::string >( crypto::hash( crypto::multicodec::sha2_256, "signature cache"s ) );
+   auto signature = util::converter::as< std::string >( foo_key.sign_compact( util::converter::to< crypto::multihash >( digest ) ) );
+
+   auto compute_remaining = ctx.resource_meter().compute_bandwidth_remaining();
+   auto recovered = chain::system_call::recover_public_key( ctx, chain::ecdsa_secp256k1, signature, digest, true );
+   auto uncached_compute = compute_remaining - ctx.resource_meter().compute_bandwidth_remaining();
+
+   BOOST_CHECK( recovered == util::converter::as< std::string >( foo_key.get_public_key() ) );
+
+   // Seeding the cache with a different key shows the thunk does not recover the key itself
+   auto cache = std::make_shared< chain::signature_cache >();
+   cache->put( signature, digest, bar_key.get_public_key() );
+   ctx.set_signature_cache( cache );
+
+   compute_remaining = ctx.resource_meter().compute_bandwidth_remaining();
+   recovered = chain::system_call::recover_public_key( ctx, chain::ecdsa_secp256k1, signature, digest, true );
+   auto cached_compute = compute_remaining - ctx.resource_meter().compute_bandwidth_remaining();
+
+   BOOST_CHECK( recovered == util::converter::as< std::string >( bar_key.get_public_key() ) );
+   BOOST_CHECK_EQUAL( cached_compute, uncached_compute );
+
+   ctx.set_signature_cache( {} );
+
+   BOOST_TEST_MESSAGE( "Test recovering block signatures" );
+
+   protocol::block block;
+   block.set_id( digest );
+   block.set_signature( signature );
+   auto trx = block.add_transactions();
+   sign_transaction( *trx, bar_key );
+   block.add_transactions()->add_signatures( "invalid signature"s );
+
+   boost::asio::thread_pool pool( 2 );
+
+   for ( const auto& block_cache : { chain::recover_block_signatures( block ), chain::recover_block_signatures( block, pool, 2 ) } )
+   {
+      BOOST_REQUIRE_EQUAL( block_cache->size(), 2 );
+
+      auto block_signer = block_cache->get( block.signature(), block.id() );
+      BOOST_REQUIRE( block_signer );
+      BOOST_CHECK( block_signer->to_address_bytes() == foo_key.get_public_key().to_address_bytes() );
+
+      auto trx_signer = block_cache->get( trx->signatures( 0 ), trx->id() );
+      BOOST_REQUIRE( trx_signer );
+      BOOST_CHECK( trx_signer->to_address_bytes() == bar_key.get_public_key().to_address_bytes() );
+   }
+
+   pool.join();
+
+   BOOST_TEST_MESSAGE( "Test keys recovered for a transaction are reused by the block" );
+
+   chain::verified_signature_cache verified( 16 );
+
+   ctx.set_verified_signatures( &verified );
+
+   compute_remaining = ctx.resource_meter().compute_bandwidth_remaining();
+   recovered = chain::system_call::recover_public_key( ctx, chain::ecdsa_secp256k1, trx->signatures( 0 ), trx->id(), true );
+   BOOST_CHECK_EQUAL( compute_remaining - ctx.resource_meter().compute_bandwidth_remaining(), uncached_compute );
+   BOOST_CHECK( recovered == util::converter::as< std::string >( bar_key.get_public_key() ) );
+   BOOST_CHECK_EQUAL( verified.stats().entries, 1 );
+
+   ctx.set_verified_signatures( nullptr );
+
+   // Seeding the verified cache with a different key shows the block does not recover the key itself
+   verified.put( block.signature(), block.id(), bar_key.get_public_key() );
+
+   auto block_cache = chain::recover_block_signatures( block, &verified );
+   BOOST_REQUIRE_EQUAL( block_cache->size(), 2 );
+   BOOST_CHECK( block_cache->get( block.signature(), block.id() )->to_address_bytes() == bar_key.get_public_key().to_address_bytes() );
+   BOOST_CHECK( block_cache->get( trx->signatures( 0 ), trx->id() )->to_address_bytes() == bar_key.get_public_key().to_address_bytes() );
+   BOOST_CHECK_EQUAL( verified.stats().hits, 2 );
+
+   BOOST_TEST_MESSAGE( "Test the verified signature cache is bounded" );
+
+   for ( int i = 0; i < 64; i++ )
+      verified.put( signature, std::to_string( i ), foo_key.get_public_key() );
+
+   BOOST_CHECK_LE( verified.stats().entries, 16 );
+} KOINOS_CATCH_LOG_AND_RETHROW(info) }
+
+BOOST_AUTO_TEST_CASE( execution_cache_test )
+{ try {
+   BOOST_TEST_MESSAGE( "Test execution contexts share a cache" );
+
+   chain::execution_context read_ctx( vm_backend, chain::intent::read_only );
+   read_ctx.set_state_node( ctx.get_state_node()->create_anonymous_node(), ctx.get_parent_node() );
+   read_ctx.set_cache( ctx.cache() );
+
+   BOOST_CHECK( &read_ctx.descriptor_pool() == &ctx.descriptor_pool() );
+   BOOST_CHECK_EQUAL( read_ctx.get_compute_bandwidth( "get_head_info" ), ctx.get_compute_bandwidth( "get_head_info" ) );
+
+   BOOST_TEST_MESSAGE( "Test writing unrelated objects leaves the cache valid" );
+
+   chain::system_call::put_object( ctx, chain::state::space::transaction_nonce(), "alice"s, "nonce"s );
+   chain::system_call::put_object( ctx, chain::state::space::metadata(), chain::state::key::head_block, "block"s );
+   BOOST_CHECK( !ctx.cache_stale() );
+
+   BOOST_TEST_MESSAGE( "Test writing a cache dependency marks the cache stale" );
+
+   auto registry = chain::system_call::get_object( ctx, chain::state::space::metadata(), chain::state::key::compute_bandwidth_registry );
+   chain::system_call::put_object( ctx, chain::state::space::metadata(), chain::state::key::compute_bandwidth_registry, registry.value() );
+   BOOST_CHECK( ctx.cache_stale() );
+   BOOST_CHECK( !read_ctx.cache_stale() );
+
+   BOOST_CHECK( chain::state::is_cache_dependency( chain::state::space::system_call_dispatch(), "any"s ) );
+   BOOST_CHECK( chain::state::is_cache_dependency( chain::state::space::contract_bytecode(), "any"s ) );
+   BOOST_CHECK( !chain::state::is_cache_dependency( chain::state::space::metadata(), chain::state::key::chain_id ) );
+} KOINOS_CATCH_LOG_AND_RETHROW(info) }
+
+BOOST_AUTO_TEST_CASE( dispatch_table_test )
+{ try {
+   BOOST_TEST_MESSAGE( "Test thunk lookups outside the dispatch table" );
+
+   const auto& dispatcher = chain::thunk_dispatcher::instance();
+   BOOST_CHECK( dispatcher.thunk_exists( chain::system_call_id::log ) );
+   BOOST_CHECK( dispatcher.thunk_is_genesis( chain::system_call_id::log ) );
+   BOOST_CHECK( !dispatcher.thunk_exists( std::numeric_limits< uint32_t >::max() ) );
+   BOOST_CHECK( !dispatcher.thunk_is_genesis( std::numeric_limits< uint32_t >::max() ) );
+
+   uint32_t bytes_written = 0;
+   BOOST_REQUIRE_THROW( dispatcher.call_thunk( std::numeric_limits< uint32_t >::max(), ctx, nullptr, 0, nullptr, 0, &bytes_written ), chain::unknown_thunk_exception );
+
+   BOOST_TEST_MESSAGE( "Test system calls resolve to the same cached entry" );
+
+   const auto& entry = ctx.resolve_system_call( chain::system_call_id::log );
+   BOOST_CHECK( &entry == &ctx.resolve_system_call( chain::system_call_id::log ) );
+   BOOST_CHECK( std::holds_alternative< chain::thunk_cache_bundle >( entry ) );
+   BOOST_CHECK_EQUAL( ctx.thunk_translation( chain::system_call_id::log ), chain::system_call_id::log );
+
+   const auto& unknown = ctx.resolve_system_call( std::numeric_limits< uint32_t >::max() );
+   BOOST_CHECK( &unknown == &ctx.resolve_system_call( std::numeric_limits< uint32_t >::max() ) );
+} KOINOS_CATCH_LOG_AND_RETHROW(info) }
+
+BOOST_AUTO_TEST_CASE( compute_cost_table_test )
+{ try {
+   BOOST_TEST_MESSAGE( "Test the compiled cost table matches the compute bandwidth registry" );
+
+   BOOST_CHECK_EQUAL( ctx.get_thunk_compute_bandwidth( chain::system_call_id::log ), ctx.get_compute_bandwidth( "log" ) );
+   BOOST_CHECK_EQUAL( ctx.get_thunk_compute_bandwidth( chain::system_call_id::hash ), ctx.get_compute_bandwidth( "hash" ) );
+
+   for ( std::size_t i = 0; i < std::size_t( chain::compute_cost::num_costs ); i++ )
+   {
+      auto c = chain::compute_cost( i );
+      BOOST_CHECK_EQUAL( ctx.get_compute_bandwidth( c ), ctx.get_compute_bandwidth( chain::compute_cost_name( c ) ) );
+   }
+
+   BOOST_REQUIRE_THROW( ctx.get_thunk_compute_bandwidth( std::numeric_limits< uint32_t >::max() ), chain::unknown_thunk_exception );
+} KOINOS_CATCH_LOG_AND_RETHROW(info) }
+
+BOOST_AUTO_TEST_CASE( exit_status_test )
+{ try {
+   BOOST_TEST_MESSAGE( "Test a successful exit is signaled without an exception" );
+
+   chain::exit_arguments args;
+   args.set_code( chain::success );
+
+   std::string arg = util::converter::as< std::string >( args );
+   std::string ret;
+   uint32_t bytes_written = 0;
+
+   chain::host_api hapi( ctx );
+   BOOST_CHECK( !hapi.exited() );
+   BOOST_CHECK_EQUAL( hapi.invoke_thunk( chain::system_call_id::exit, ret.data(), uint32_t( ret.size() ), arg.data(), uint32_t( arg.size() ), &bytes_written ), chain::success );
+   BOOST_CHECK( hapi.exited() );
+
+   BOOST_TEST_MESSAGE( "Test native callers still unwind on exit" );
+
+   BOOST_CHECK_THROW( chain::system_call::exit( ctx, chain::success, chain::result() ), chain::success_exception );
+
+   BOOST_TEST_MESSAGE( "Test a failed exit is still thrown" );
+
+   args.set_code( chain::failure );
+   args.mutable_res()->mutable_error()->set_message( "failure" );
+   arg = util::converter::as< std::string >( args );
+
+   chain::host_api failed_hapi( ctx );
+   BOOST_CHECK_THROW( failed_hapi.invoke_thunk( chain::system_call_id::exit, ret.data(), uint32_t( ret.size() ), arg.data(), uint32_t( arg.size() ), &bytes_written ), chain::failure_exception );
+   BOOST_CHECK( !failed_hapi.exited() );
+} KOINOS_CATCH_LOG_AND_RETHROW(info) }
+
+BOOST_AUTO_TEST_CASE( parallel_merge_test )
+{ try {
+   BOOST_TEST_MESSAGE( "Test merging resource meters" );
+
+   chain::resource_limit_data rld;
+   rld.set_disk_storage_limit( 100 );
+   rld.set_network_bandwidth_limit( 100 );
+   rld.set_compute_bandwidth_limit( 100 );
+
+   chain::resource_meter block_meter;
+   block_meter.set_resource_limit_data( rld );
+
+   const auto start_meter = block_meter;
+
+   chain::resource_meter first = start_meter;
+   first.mark();
+   first.use_disk_storage( 60 );
+   first.use_disk_storage( -50 );
+   first.use_compute_bandwidth( 30 );
+
+   chain::resource_meter second = start_meter;
+   second.mark();
+   second.use_disk_storage( 50 );
+   second.use_network_bandwidth( 20 );
+
+   BOOST_REQUIRE( block_meter.merge( start_meter, first ) );
+   BOOST_CHECK_EQUAL( block_meter.disk_storage_remaining(), 90 );
+   BOOST_CHECK_EQUAL( block_meter.compute_bandwidth_remaining(), 70 );
+
+   BOOST_REQUIRE( block_meter.merge( start_meter, second ) );
+   BOOST_CHECK_EQUAL( block_meter.disk_storage_remaining(), 40 );
+   BOOST_CHECK_EQUAL( block_meter.network_bandwidth_remaining(), 80 );
+   BOOST_CHECK_EQUAL( block_meter.system_disk_storage_used(), 60 );
+
+   BOOST_TEST_MESSAGE( "Test a meter that peaked above what remains is not merged" );
+
+   BOOST_CHECK( !block_meter.merge( start_meter, first ) );
+   BOOST_CHECK_EQUAL( block_meter.disk_storage_remaining(), 40 );
+
+   BOOST_TEST_MESSAGE( "Test state access conflicts" );
+
+   chain::object_space space;
+   space.set_id( 1 );
+
+   chain::object_space other_space;
+   other_space.set_id( 2 );
+
+   chain::state_access_set written;
+   written.record_write( space, "a" );
+
+   chain::state_access_set reader;
+   reader.record_read( space, "b" );
+   reader.record_read( other_space, "a" );
+   BOOST_CHECK( !reader.conflicts_with( written ) );
+
+   reader.record_read( space, "a" );
+   BOOST_CHECK( reader.conflicts_with( written ) );
+
+   chain::state_access_set writer;
+   writer.record_write( space, "a" );
+   BOOST_CHECK( writer.conflicts_with( written ) );
+
+   chain::state_access_set range_reader;
+   range_reader.record_range_read( other_space );
+   BOOST_CHECK( !range_reader.conflicts_with( written ) );
+
+   range_reader.record_range_read( space );
+   BOOST_CHECK( range_reader.conflicts_with( written ) );
+} KOINOS_CATCH_LOG_AND_RETHROW(info) }
+
+BOOST_AUTO_TEST_CASE( merkle_root_test )
+{ try {
+   BOOST_TEST_MESSAGE( "Test streaming merkle roots match merkle trees" );
+
+   chain::resource_limit_data rld;
+   rld.set_compute_bandwidth_limit( 10'000'000'000 );
+   ctx.resource_meter().set_resource_limit_data( rld );
+
+   std::vector< crypto::multihash > leaves;
+   std::vector< std::string > string_leaves;
+
+   for ( std::size_t i = 0; i <= 70; i++ )
+   {
+      auto tree_root = crypto::merkle_tree( crypto::multicodec::sha2_256, leaves ).root()->hash();
+      auto root = util::converter::as< std::string >( tree_root );
+
+      BOOST_CHECK( chain::system_call::verify_merkle_root( ctx, root, string_leaves ) );
+
+      if ( leaves.size() )
+      {
+         std::string digests;
+         for ( const auto& leaf : leaves )
+            digests.append( reinterpret_cast< const char* >( leaf.digest().data() ), leaf.digest().size() );
+
+         auto streamed_root = chain::merkle::sha256_merkle_root( digests );
+         BOOST_CHECK( std::equal( streamed_root.begin(), streamed_root.end(), reinterpret_cast< const char* >( tree_root.digest().data() ) ) );
+
+         auto tampered = string_leaves;
+         tampered.back().back() ^= 1;
+         BOOST_CHECK( !chain::system_call::verify_merkle_root( ctx, root, tampered ) );
+      }
+
+      leaves.push_back( crypto::hash( crypto::multicodec::sha2_256, std::to_string( i ) ) );
+      string_leaves.push_back( util::converter::as< std::string >( leaves.back() ) );
+   }
+
+   BOOST_TEST_MESSAGE( "Test mismatched leaves are rejected" );
+
+   auto root = util::converter::as< std::string >( crypto::merkle_tree( crypto::multicodec::sha2_256, leaves ).root()->hash() );
+   string_leaves.push_back( util::converter::as< std::string >( crypto::hash( crypto::multicodec::sha2_512, "leaf"s ) ) );
+   BOOST_CHECK_THROW( chain::system_call::verify_merkle_root( ctx, root, string_leaves ), koinos::exception );
+
+   BOOST_TEST_MESSAGE( "Benchmark merkle root computation" );
+
+   constexpr std::size_t num_leaves = 4096;
+   constexpr std::size_t runs = 20;
+
+   leaves.clear();
+   std::string digests;
+
+   for ( std::size_t i = 0; i < num_leaves; i++ )
+   {
+      leaves.push_back( crypto::hash( crypto::multicodec::sha2_256, std::to_string( i ) ) );
+      digests.append( reinterpret_cast< const char* >( leaves.back().digest().data() ), leaves.back().digest().size() );
+   }
+
+   auto start = std::chrono::steady_clock::now();
+   for ( std::size_t i = 0; i < runs; i++ )
+      crypto::merkle_tree( crypto::multicodec::sha2_256, leaves );
+   auto tree_time = std::chrono::duration< double >( std::chrono::steady_clock::now() - start ).count();
+
+   start = std::chrono::steady_clock::now();
+   for ( std::size_t i = 0; i < runs; i++ )
+   {
+      auto scratch = digests;
+      chain::merkle::sha256_merkle_root( scratch );
+   }
+   auto streamed_time = std::chrono::duration< double >( std::chrono::steady_clock::now() - start ).count();
+
+   BOOST_TEST_MESSAGE( "merkle_tree: " << uint64_t( num_leaves * runs / tree_time ) << " leaves/s" );
+   BOOST_TEST_MESSAGE( "sha256_merkle_root: " << uint64_t( num_leaves * runs / streamed_time ) << " leaves/s" );
+} KOINOS_CATCH_LOG_AND_RETHROW(info) }
+
+BOOST_AUTO_TEST_CASE( hash_batch_test )
+{ try {
+   BOOST_TEST_MESSAGE( "Test batched hashes match individual hashes" );
+
+   chain::resource_limit_data rld;
+   rld.set_compute_bandwidth_limit( 10'000'000'000 );
+   ctx.resource_meter().set_resource_limit_data( rld );
+
+   std::vector< std::string > inputs;
+   for ( std::size_t i = 0; i < 200; i++ )
+      inputs.emplace_back( i, char( i ) );
+
+   std::vector< const std::string* > input_ptrs;
+   for ( const auto& input : inputs )
+      input_ptrs.push_back( &input );
+
+   for ( auto code : { crypto::multicodec::sha2_256, crypto::multicodec::sha2_512, crypto::multicodec::ripemd_160 } )
+   {
+      auto start = ctx.resource_meter().compute_bandwidth_remaining();
+
+      std::vector< std::string > expected;
+      for ( const auto& input : inputs )
+         expected.push_back( chain::system_call::hash( ctx, std::underlying_type_t< crypto::multicodec >( code ), input ) );
+
+      auto individual_compute = start - ctx.resource_meter().compute_bandwidth_remaining();
+      start = ctx.resource_meter().compute_bandwidth_remaining();
+
+      auto hashes = chain::hash_batch( ctx, std::underlying_type_t< crypto::multicodec >( code ), input_ptrs );
+
+      BOOST_CHECK( hashes == expected );
+      BOOST_CHECK_EQUAL( start - ctx.resource_meter().compute_bandwidth_remaining(), individual_compute );
+   }
+
+   BOOST_CHECK( chain::hash_batch( ctx, std::underlying_type_t< crypto::multicodec >( crypto::multicodec::sha2_256 ), {} ).empty() );
+   BOOST_CHECK_THROW( chain::hash_batch( ctx, 0xDEADBEEF /* unknown code */, input_ptrs ), koinos::chain::unknown_hash_code_exception );
+
+   BOOST_TEST_MESSAGE( "Test batched hashes run out of compute at the same input" );
+
+   rld.set_compute_bandwidth_limit( 20'000 );
+
+   ctx.resource_meter().set_resource_limit_data( rld );
+   BOOST_CHECK_THROW(
+      for ( const auto& input : inputs )
+         chain::system_call::hash( ctx, std::underlying_type_t< crypto::multicodec >( crypto::multicodec::sha2_256 ), input ),
+      koinos::exception
+   );
+   auto individual_remaining = ctx.resource_meter().compute_bandwidth_remaining();
+
+   ctx.resource_meter().set_resource_limit_data( rld );
+   BOOST_CHECK_THROW( chain::hash_batch( ctx, std::underlying_type_t< crypto::multicodec >( crypto::multicodec::sha2_256 ), input_ptrs ), koinos::exception );
+   BOOST_CHECK_EQUAL( ctx.resource_meter().compute_bandwidth_remaining(), individual_remaining );
+} KOINOS_CATCH_LOG_AND_RETHROW(info) }
+
+BOOST_AUTO_TEST_CASE( instance_pool_test )
+{ try {
+   BOOST_TEST_MESSAGE( "Test pooled instances are reset between calls" );
+
+   auto contract_private_key = koinos::crypto::private_key::regenerate( koinos::crypto::hash( koinos::crypto::multicodec::sha2_256, "contract"s ) );
+   koinos::protocol::transaction trx;
+   sign_transaction( trx, contract_private_key );
+   ctx.set_transaction( trx );
+
+   koinos::protocol::upload_contract_operation op;
+   op.set_contract_id( util::converter::as< std::string >( contract_private_key.get_public_key().to_address_bytes() ) );
+   op.set_bytecode( get_contract_return_wasm() );
+   koinos::chain::system_call::apply_upload_contract_operation( ctx, op );
+
+   for ( const auto& args : { "echo"s, "a much longer argument than before"s, "x"s, ""s, "echo"s } )
+      BOOST_REQUIRE_EQUAL( koinos::chain::system_call::call( ctx, op.contract_id(), 0, args ), args );
+
+   BOOST_TEST_MESSAGE( "Test repeated calls to a pooled contract" );
+
+   op.set_bytecode( get_hello_wasm() );
+   koinos::chain::system_call::apply_upload_contract_operation( ctx, op );
+
+   koinos::protocol::call_contract_operation op2;
+   op2.set_contract_id( op.contract_id() );
+
+   auto num_logs = ctx.chronicler().logs().size();
+
+   for ( int i = 0; i < 3; i++ )
+      koinos::chain::system_call::apply_call_contract_operation( ctx, op2 );
+
+   const auto& logs = ctx.chronicler().logs();
+   BOOST_REQUIRE_EQUAL( logs.size(), num_logs + 3 );
+   for ( auto i = num_logs; i < logs.size(); i++ )
+      BOOST_REQUIRE_EQUAL( logs[ i ], "Greetings from koinos vm" );
+} KOINOS_CATCH_LOG_AND_RETHROW(info) }
+
+BOOST_AUTO_TEST_CASE( start_section_host_call )
+{ try {
+   BOOST_TEST_MESSAGE( "Test a module whose start section calls the host fails to instantiate" );
+
+   // A module importing the given host function and calling it with zeroed arguments from its start section
+   auto start_section_wasm = []( const std::string& import )
+   {
+      std::string wasm( "\0asm\x01\0\0\0"s );
+
+      auto section = [&]( char id, const std::string& payload )
+      {
+         wasm.push_back( id );
+         wasm.push_back( char( payload.size() ) );
+         wasm += payload;
+      };
+
+      section( 1, "\x02\x60\x06\x7f\x7f\x7f\x7f\x7f\x7f\x01\x7f\x60\0\0"s );
+      section( 2, "\x01\x03" "env"s + char( import.size() ) + import + "\0\0"s );
+      section( 3, "\x01\x01"s );
+      section( 5, "\x01\0\x01"s );
+      section( 7, "\x01\x06" "_start\0\x01"s );
+      section( 8, "\x01"s );
+      section( 10, "\x01\x11\0\x41\0\x41\0\x41\0\x41\0\x41\0\x41\0\x10\0\x1a\x0b"s );
+
+      return wasm;
+   };
+
+   auto contract_private_key = koinos::crypto::private_key::regenerate( koinos::crypto::hash( koinos::crypto::multicodec::sha2_256, "start"s ) );
+   koinos::protocol::transaction trx;
+   sign_transaction( trx, contract_private_key );
+   ctx.set_transaction( trx );
+
+   koinos::protocol::upload_contract_operation op;
+   op.set_contract_id( util::converter::as< std::string >( contract_private_key.get_public_key().to_address_bytes() ) );
+
+   for ( const auto& import : { "invoke_thunk"s, "invoke_system_call"s } )
+   {
+      op.set_bytecode( start_section_wasm( import ) );
+      koinos::chain::system_call::apply_upload_contract_operation( ctx, op );
+
+      // Twice, so the second call goes through the module cache
+      for ( int i = 0; i < 2; i++ )
+         BOOST_CHECK_THROW( koinos::chain::system_call::call( ctx, op.contract_id(), 0, ""s ), koinos::vm_manager::fizzy::module_instantiate_exception );
+   }
+} KOINOS_CATCH_LOG_AND_RETHROW(info) }
+
+BOOST_AUTO_TEST_CASE( module_cache_test )
+{ try {
+   BOOST_TEST_MESSAGE( "Test the module cache is bounded by bytecode size" );
+
+   using koinos::vm_manager::fizzy::module_cache;
+   using koinos::vm_manager::fizzy::module_guard;
+
+   // 1600 bytes holds 26 modules of 60 bytes, whichever shards they fall in
+   module_cache cache( 1'600 );
+   const std::size_t num_modules = 64;
+
+   for ( std::size_t i = 0; i < num_modules; i++ )
+      cache.put_module( std::to_string( i ), std::make_shared< const module_guard >( nullptr ), 60 );
+
+   auto stats = cache.stats();
+   BOOST_REQUIRE_EQUAL( stats.modules, 26 );
+   BOOST_REQUIRE_EQUAL( stats.modules + stats.evictions, num_modules );
+   BOOST_REQUIRE_EQUAL( stats.bytes, stats.modules * 60 );
+   BOOST_REQUIRE_EQUAL( stats.rejected, 0 );
+
+   std::size_t found = 0;
+   for ( std::size_t i = 0; i < num_modules; i++ )
+      if ( cache.get_module( std::to_string( i ) ) )
+         found++;
+
+   stats = cache.stats();
+   BOOST_REQUIRE_EQUAL( found, stats.modules );
+   BOOST_REQUIRE_EQUAL( stats.hits, found );
+   BOOST_REQUIRE_EQUAL( stats.misses, num_modules - found );
+
+   BOOST_TEST_MESSAGE( "Test modules larger than a shard's share of the capacity are cached" );
+
+   cache.put_module( "large"s, std::make_shared< const module_guard >( nullptr ), 1'000 );
+   BOOST_REQUIRE( cache.get_module( "large"s ) );
+
+   stats = cache.stats();
+   BOOST_REQUIRE( stats.bytes <= 1'600 );
+   BOOST_REQUIRE_EQUAL( stats.modules, 11 );
+   BOOST_REQUIRE_EQUAL( stats.rejected, 0 );
+
+   BOOST_TEST_MESSAGE( "Test modules larger than the capacity are rejected" );
+
+   cache.put_module( "oversize"s, std::make_shared< const module_guard >( nullptr ), 1'601 );
+   BOOST_REQUIRE( !cache.get_module( "oversize"s ) );
+   BOOST_REQUIRE( cache.get_module( "large"s ) );
+
+   stats = cache.stats();
+   BOOST_REQUIRE_EQUAL( stats.rejected, 1 );
+   BOOST_REQUIRE_EQUAL( stats.modules, 11 );
+} KOINOS_CATCH_LOG_AND_RETHROW(info) }
+
+BOOST_AUTO_TEST_CASE( module_store_test )
+{ try {
+   BOOST_TEST_MESSAGE( "Test storing and loading modules" );
+
+   koinos::vm_manager::fizzy::module_store store( temp / "modules" );
+
+   auto hello_id  = util::converter::as< std::string >( crypto::hash( crypto::multicodec::sha2_256, get_hello_wasm() ) );
+   auto return_id = util::converter::as< std::string >( crypto::hash( crypto::multicodec::sha2_256, get_contract_return_wasm() ) );
+
+   BOOST_REQUIRE( !store.contains( hello_id ) );
+   BOOST_REQUIRE( !store.get( hello_id ) );
+
+   store.put( hello_id, get_hello_wasm() );
+   store.put( return_id, get_contract_return_wasm() );
+
+   BOOST_REQUIRE( store.contains( hello_id ) );
+   BOOST_REQUIRE( *store.get( hello_id ) == get_hello_wasm() );
+   BOOST_REQUIRE( *store.get( return_id ) == get_contract_return_wasm() );
+
+   auto ids = store.ids();
+   BOOST_REQUIRE_EQUAL( ids.size(), 2 );
+   BOOST_REQUIRE( std::find( ids.begin(), ids.end(), hello_id ) != ids.end() );
+   BOOST_REQUIRE( std::find( ids.begin(), ids.end(), return_id ) != ids.end() );
+
+   BOOST_TEST_MESSAGE( "Test corrupt modules are removed" );
+
+   auto path = temp / "modules" / util::to_hex( hello_id );
+   {
+      std::fstream fs( path, std::ios::binary | std::ios::in | std::ios::out );
+      fs.seekg( -1, std::ios::end );
+      char last = fs.get();
+      fs.seekp( -1, std::ios::end );
+      fs.put( ~last );
+   }
+
+   BOOST_REQUIRE( !store.get( hello_id ) );
+   BOOST_REQUIRE( !store.contains( hello_id ) );
+   BOOST_REQUIRE( *store.get( return_id ) == get_contract_return_wasm() );
+
+   BOOST_TEST_MESSAGE( "Test modules that do not hash to their id are removed" );
+
+   // A valid file with a valid checksum, stored under the id of another module
+   store.put( hello_id, get_contract_return_wasm() );
+   BOOST_REQUIRE( store.contains( hello_id ) );
+   BOOST_REQUIRE( !store.get( hello_id ) );
+   BOOST_REQUIRE( !store.contains( hello_id ) );
+
+   store.put( "hello"s, get_hello_wasm() );
+   BOOST_REQUIRE( !store.get( "hello"s ) );
+   BOOST_REQUIRE( !store.contains( "hello"s ) );
+
+   BOOST_TEST_MESSAGE( "Test listing a missing directory does not throw" );
+
+   std::filesystem::remove_all( temp / "modules" );
+   BOOST_REQUIRE( store.ids().empty() );
+} KOINOS_CATCH_LOG_AND_RETHROW(info) }
+
 BOOST_AUTO_TEST_SUITE_END()